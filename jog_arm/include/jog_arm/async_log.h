@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : async_log.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Logging that never blocks the jogging calculations.
+
+#ifndef JOG_ARM_ASYNC_LOG_H
+#define JOG_ARM_ASYNC_LOG_H
+
+#include <pthread.h>
+#include <ros/console.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Log from a hot path. Formatted printf-style into a queue and written to rosconsole by a
+// low-priority thread. A call site logs at most once per period [s]. The skipped messages
+// are counted and reported with the next one.
+#define JOG_ARM_ASYNC_LOG_THROTTLE_NAMED(level, period, name, ...)                                                   \
+  do                                                                                                                 \
+  {                                                                                                                  \
+    static ::jog_arm::AsyncLogSite jog_arm_async_log_site_(level, period, name, __FILE__, __LINE__, __FUNCTION__);  \
+    ::jog_arm::AsyncLog::instance().log(jog_arm_async_log_site_, __VA_ARGS__);                                       \
+  } while (0)
+
+#define JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(period, name, ...)                                                         \
+  JOG_ARM_ASYNC_LOG_THROTTLE_NAMED(::ros::console::levels::Warn, period, name, __VA_ARGS__)
+#define JOG_ARM_ASYNC_ERROR_THROTTLE_NAMED(period, name, ...)                                                        \
+  JOG_ARM_ASYNC_LOG_THROTTLE_NAMED(::ros::console::levels::Error, period, name, __VA_ARGS__)
+
+namespace jog_arm
+{
+// One per call site of the JOG_ARM_ASYNC_* macros
+struct AsyncLogSite
+{
+  AsyncLogSite(ros::console::Level level, double period, const char* name, const char* file, int line,
+               const char* function);
+
+  const ros::console::Level level;
+  const int64_t period_ns;
+  const char* const name;
+  const char* const file;
+  const int line;
+  const char* const function;
+
+  // When the site may log again, on the steady clock [ns]
+  std::atomic<int64_t> next_time_ns;
+
+  // Messages skipped by the rate limit or dropped because the queue was full, since the last one queued
+  std::atomic<uint32_t> suppressed;
+
+  // Resolved by the logging thread only
+  ros::console::LogLocation location;
+};
+
+/**
+ * Class AsyncLog - A bounded, lock-free queue of formatted log messages. Any
+ * thread can add to it without blocking. One low-priority thread wakes up
+ * periodically and writes the messages to rosconsole. If the queue is full,
+ * the message is dropped and counted. The logging thread starts with the
+ * first call to instance(). The instance is never destroyed, so threads
+ * that still log while the process exits don't touch a dead object.
+ */
+class AsyncLog
+{
+public:
+  static AsyncLog& instance();
+
+  // Write the queued messages and join the logging thread. Call it once the threads that log are joined,
+  // before rosconsole shuts down. Later messages are queued, but not written.
+  void stop();
+
+  // Format and queue a message, unless site logged less than a period ago or the queue is full
+  void log(AsyncLogSite& site, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+  // Messages dropped because the queue was full
+  uint64_t droppedCount() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  AsyncLog();
+
+  static const std::size_t QUEUE_CAPACITY = 256;  // A power of 2
+  static const std::size_t MAX_MESSAGE_LENGTH = 256;
+
+  struct Record
+  {
+    // The queue position this record is ready for. Written last by producers, first by the consumer.
+    std::atomic<std::size_t> sequence;
+    AsyncLogSite* site;
+    uint32_t suppressed;
+    char text[MAX_MESSAGE_LENGTH];
+  };
+
+  static void* drainThread(void* arg);
+
+  // Write every queued message. False if there were none.
+  bool drain();
+
+  void write(AsyncLogSite& site, const char* text, uint32_t suppressed);
+
+  std::unique_ptr<Record[]> records_;
+  std::atomic<std::size_t> enqueue_position_;
+  // Only touched by the logging thread
+  std::size_t dequeue_position_ = 0;
+  uint64_t reported_dropped_ = 0;
+
+  std::atomic<uint64_t> dropped_;
+  std::atomic<bool> stop_;
+  pthread_t thread_;
+  bool thread_started_ = false;
+};
+}  // namespace jog_arm
+
+#endif  // JOG_ARM_ASYNC_LOG_H
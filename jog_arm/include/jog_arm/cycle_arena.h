@@ -0,0 +1,224 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : cycle_arena.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Per-cycle bump allocator for outgoing messages.
+
+#ifndef JOG_ARM_CYCLE_ARENA_H
+#define JOG_ARM_CYCLE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace jog_arm
+{
+/**
+ * Class CycleArena - Hands out memory from one block by bumping an offset.
+ * Nothing is freed individually. reset() makes the whole block reusable, so
+ * messages rebuilt every cycle stop touching the heap once the block is big
+ * enough. If a cycle overflows the block, more blocks are chained on and
+ * merged into one at the next reset(). Not thread-safe.
+ */
+class CycleArena
+{
+public:
+  explicit CycleArena(std::size_t initial_capacity = 4096);
+
+  void* allocate(std::size_t bytes, std::size_t alignment);
+
+  // Reuse all of the memory. Whatever was allocated from the arena is invalid afterwards.
+  void reset();
+
+  // Total bytes in the blocks
+  std::size_t capacity() const;
+
+private:
+  struct Block
+  {
+    std::unique_ptr<char[]> data;
+    std::size_t size;
+  };
+
+  void addBlock(std::size_t size);
+
+  std::vector<Block> blocks_;
+
+  // Bytes used in the last block
+  std::size_t offset_ = 0;
+};
+
+/**
+ * Class ArenaAllocator - Standard allocator backed by a CycleArena, for
+ * instantiating message types like trajectory_msgs::JointTrajectory_<ArenaAllocator<void>>.
+ * Without an arena it behaves like std::allocator. Copies of a container
+ * always go to the heap, so a message can be copied out of the arena and
+ * handed to another thread. Moves keep the arena.
+ */
+template <class T>
+class ArenaAllocator
+{
+public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  typedef std::false_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  template <class U>
+  struct rebind
+  {
+    typedef ArenaAllocator<U> other;
+  };
+
+  ArenaAllocator() noexcept : arena_(nullptr)
+  {
+  }
+
+  explicit ArenaAllocator(CycleArena* arena) noexcept : arena_(arena)
+  {
+  }
+
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena())
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    if (arena_)
+      return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, std::size_t /*n*/)
+  {
+    if (!arena_)
+      ::operator delete(p);
+  }
+
+  template <class U, class... Args>
+  void construct(U* p, Args&&... args)
+  {
+    ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+  }
+
+  template <class U>
+  void destroy(U* p)
+  {
+    p->~U();
+  }
+
+  std::size_t max_size() const noexcept
+  {
+    return static_cast<std::size_t>(-1) / sizeof(T);
+  }
+
+  ArenaAllocator select_on_container_copy_construction() const
+  {
+    return ArenaAllocator();
+  }
+
+  CycleArena* arena() const
+  {
+    return arena_;
+  }
+
+private:
+  CycleArena* arena_;
+};
+
+// Message types are instantiated with the void allocator and rebind it per member
+template <>
+class ArenaAllocator<void>
+{
+public:
+  typedef void value_type;
+  typedef void* pointer;
+  typedef const void* const_pointer;
+
+  template <class U>
+  struct rebind
+  {
+    typedef ArenaAllocator<U> other;
+  };
+
+  ArenaAllocator() noexcept : arena_(nullptr)
+  {
+  }
+
+  explicit ArenaAllocator(CycleArena* arena) noexcept : arena_(arena)
+  {
+  }
+
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena())
+  {
+  }
+
+  CycleArena* arena() const
+  {
+    return arena_;
+  }
+
+private:
+  CycleArena* arena_;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+  return a.arena() == b.arena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+  return a.arena() != b.arena();
+}
+}  // namespace jog_arm
+
+#endif  // JOG_ARM_CYCLE_ARENA_H
@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : evdev_joystick.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Reads a joystick straight from its Linux evdev device, without joy_node.
+
+#ifndef JOG_ARM_EVDEV_JOYSTICK_H
+#define JOG_ARM_EVDEV_JOYSTICK_H
+
+#include <linux/input.h>
+#include <pthread.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace jog_arm
+{
+/**
+ * Class EvdevJoystick - Waits on the device with epoll in a thread of its own
+ * and hands each batch of input to a callback. Axes and buttons are numbered
+ * and scaled like the sensor_msgs/Joy from joy_node, so the same mappings
+ * work for both. If the device is missing or unplugged, opening it is retried.
+ */
+class EvdevJoystick
+{
+public:
+  // Called from the reader thread. Return true while the input commands motion. The last input is then
+  // repeated every repeat_period, so a held stick doesn't go stale.
+  typedef std::function<bool(const std::vector<float>& axes, const std::vector<int32_t>& buttons)> Callback;
+
+  // device is an event device, e.g. /dev/input/by-id/usb-..-event-joystick. repeat_period in [s].
+  EvdevJoystick(const std::string& device, double repeat_period, Callback callback);
+
+  ~EvdevJoystick();
+
+  // Start the reader thread
+  bool start();
+
+  // Stop and join the reader thread
+  void stop();
+
+private:
+  static void* readerThread(void* joystick);
+
+  void read();
+
+  bool openDevice();
+  void closeDevice();
+
+  // Read the whole current state, after opening or after the kernel dropped events
+  void synchronize();
+
+  // Read every pending event. Returns false if the device is gone.
+  bool readEvents();
+
+  // Number the axes and buttons like the Linux joystick API, which joy_node reads
+  void numberInputs(const std::vector<uint8_t>& abs_bits, const std::vector<uint8_t>& key_bits);
+
+  // Scale a raw axis value to [-1:1], with the sign joy_node uses
+  float scaleAxis(std::size_t axis, int value) const;
+
+  std::string device_;
+  double repeat_period_;
+  Callback callback_;
+
+  int device_fd_ = -1;
+  int epoll_fd_ = -1;
+  // Written by stop() to wake the reader thread
+  int stop_fd_ = -1;
+
+  // Axis or button index of each event code, or -1
+  std::vector<int> axis_indices_;
+  std::vector<int> button_indices_;
+  std::vector<int> axis_codes_;
+  std::vector<input_absinfo> axis_info_;
+
+  std::vector<float> axes_;
+  std::vector<int32_t> buttons_;
+
+  // The kernel's buffer overflowed. Events are ignored until the next SYN_REPORT, then the state is read again.
+  bool dropped_ = false;
+
+  // The last callback commanded motion
+  bool active_ = false;
+
+  pthread_t thread_;
+  bool thread_started_ = false;
+};
+}  // namespace jog_arm
+
+#endif  // JOG_ARM_EVDEV_JOYSTICK_H
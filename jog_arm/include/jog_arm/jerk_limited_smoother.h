@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : jerk_limited_smoother.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Online jerk-limited smoothing of outgoing joint commands.
+
+#ifndef JOG_ARM_JERK_LIMITED_SMOOTHER_H
+#define JOG_ARM_JERK_LIMITED_SMOOTHER_H
+
+#include <Eigen/Core>
+
+namespace jog_arm
+{
+/**
+ * Class JerkLimitedSmoother - Each cycle, moves every joint's velocity toward
+ * a target as quickly as the velocity, acceleration and jerk limits allow.
+ * The acceleration is ramped down early enough to land on the target
+ * velocity without overshoot. Positions are integrated from the smoothed
+ * velocities, so halts and restarts become ramps instead of steps.
+ */
+class JerkLimitedSmoother
+{
+public:
+  JerkLimitedSmoother(const Eigen::VectorXd& max_velocity, const Eigen::VectorXd& max_acceleration,
+                      const Eigen::VectorXd& max_jerk, double sample_period);
+
+  // Start from rest at these positions
+  void reset(const double* position);
+
+  // Change the limits without disturbing the current motion
+  void setLimits(const Eigen::VectorXd& max_acceleration, const Eigen::VectorXd& max_jerk);
+
+  // Advance one sample period toward the target velocities
+  void update(const Eigen::VectorXd& target_velocity);
+
+  // True if no joint is moving or accelerating
+  bool isAtRest() const;
+
+  const Eigen::VectorXd& position() const
+  {
+    return position_;
+  }
+  const Eigen::VectorXd& velocity() const
+  {
+    return velocity_;
+  }
+  const Eigen::VectorXd& acceleration() const
+  {
+    return acceleration_;
+  }
+
+private:
+  Eigen::VectorXd max_velocity_, max_acceleration_, max_jerk_;
+  double sample_period_;
+
+  Eigen::VectorXd position_, velocity_, acceleration_;
+};
+}  // namespace jog_arm
+
+#endif  // JOG_ARM_JERK_LIMITED_SMOOTHER_H
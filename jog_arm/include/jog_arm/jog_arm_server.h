@@ -43,8 +43,24 @@
 #define JOG_ARM_SERVER_H
 
 #include <Eigen/Eigenvalues>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <geometry_msgs/PoseStamped.h>
+#include <geometry_msgs/TwistStamped.h>
+#include <jog_arm/async_log.h>
+#include <jog_arm/evdev_joystick.h>
+#include <jog_arm/jerk_limited_smoother.h>
+#include <jog_arm/joint_state_estimator.h>
+#include <jog_arm/joint_state_parser.h>
+#include <jog_arm/joy_mapping.h>
+#include <jog_arm/low_pass_filter_bank.h>
+#include <jog_arm/periodic_task_executor.h>
+#include <jog_arm/robot_model_cache.h>
+#include <jog_arm/serialized_trajectory.h>
+#include <jog_msgs/JogFrame.h>
 #include <jog_msgs/JogJoint.h>
-#include <moveit/move_group_interface/move_group_interface.h>
+#include <jog_msgs/JogStatus.h>
 #include <moveit/planning_scene/planning_scene.h>
 #include <moveit/planning_scene_interface/planning_scene_interface.h>
 #include <moveit/robot_model_loader/robot_model_loader.h>
@@ -54,24 +70,43 @@
 #include <sensor_msgs/Joy.h>
 #include <std_msgs/Bool.h>
 #include <std_msgs/Float64MultiArray.h>
+#include <std_srvs/Trigger.h>
 #include <tf/transform_listener.h>
 #include <trajectory_msgs/JointTrajectory.h>
 
 namespace jog_arm
 {
+struct jog_arm_parameters;
+
 // Variables to share between threads, and their mutexes
 struct jog_arm_shared
 {
   geometry_msgs::TwistStamped command_deltas;
   pthread_mutex_t command_deltas_mutex;
 
+  // Set by a JogFrame command, which also sets the frame of command_deltas.
+  // An empty link is the move group's tip. Guarded by command_deltas_mutex.
+  bool frame_cmd_flag = false;
+  std::string command_link;
+  bool command_avoids_collisions = true;
+
+  // The latest target pose. Servoed to instead of following command_deltas while pose_cmd_flag is set.
+  // Guarded by command_deltas_mutex.
+  geometry_msgs::PoseStamped pose_command;
+  bool pose_cmd_flag = false;
+
   jog_msgs::JogJoint joint_command_deltas;
   pthread_mutex_t joint_command_deltas_mutex;
 
-  sensor_msgs::JointState joints;
+  // The move group's joints from the latest joint_states msg, in move group order
+  JointStateFrame joints;
   pthread_mutex_t joints_mutex;
 
   double collision_velocity_scale = 1;
+  // What collision checking found, as a jog_msgs::JogStatus code, and a link in collision.
+  // Guarded by collision_velocity_scale_mutex.
+  uint8_t collision_status = jog_msgs::JogStatus::OK;
+  std::string collision_link;
   pthread_mutex_t collision_velocity_scale_mutex;
 
   // Indicates that an incoming Cartesian command is all zero velocities
@@ -86,8 +121,8 @@ struct jog_arm_shared
   bool command_is_stale = false;
   pthread_mutex_t command_is_stale_mutex;
 
-  // The new trajectory which is calculated
-  trajectory_msgs::JointTrajectory new_traj;
+  // The new trajectory which is calculated. Always on the heap.
+  JogTrajectory new_traj;
   pthread_mutex_t new_traj_mutex;
 
   // Timestamp of incoming commands
@@ -96,101 +131,218 @@ struct jog_arm_shared
 
   bool ok_to_publish = false;
   pthread_mutex_t ok_to_publish_mutex;
+
+  // Tells the worker threads to finish
+  bool stop_requested = false;
+  pthread_mutex_t stop_requested_mutex;
+
+  // When the server started. Written before the worker threads run.
+  ros::WallTime start_time;
+
+  // The latest parameters. A reload shares a new block instead of modifying this one.
+  // The worker threads pick it up at the start of a cycle.
+  std::atomic<const jog_arm_parameters*> parameters{ nullptr };
+
+  // Indicates that the latest command jogs this group together with its partner
+  bool coordinated_cmd_flag = false;
+  pthread_mutex_t coordinated_cmd_flag_mutex;
+};
+
+// Commands for two move groups that are jogged together
+struct jog_arm_coordinated_shared
+{
+  // Twist of the object halfway between the end effectors
+  geometry_msgs::TwistStamped object_command;
+  // Twist of the second end effector relative to the first
+  geometry_msgs::TwistStamped relative_command;
+  pthread_mutex_t command_mutex;
 };
 
 // ROS params to be read
 struct jog_arm_parameters
 {
   std::string move_group_name, joint_topic, cartesian_command_in_topic, command_frame, command_out_topic,
-      planning_frame, warning_topic, joint_command_in_topic, command_in_type, command_out_type;
+      planning_frame, warning_topic, status_topic, joint_command_in_topic, command_in_type, command_out_type, low_pass_filter_type,
+      coordinated_partner_move_group_name, object_command_in_topic, relative_command_in_topic, direct_input_device,
+      frame_command_in_topic, pose_command_in_topic;
   double linear_scale, rotational_scale, joint_scale, lower_singularity_threshold, hard_stop_singularity_threshold,
-      lower_collision_proximity_threshold, hard_stop_collision_proximity_threshold, low_pass_filter_coeff,
-      publish_period, publish_delay, incoming_command_timeout, joint_limit_margin, collision_check_rate;
-  bool gazebo, collision_check, publish_joint_positions, publish_joint_velocities, publish_joint_accelerations;
+      lower_collision_proximity_threshold, hard_stop_collision_proximity_threshold, low_pass_filter_cutoff_frequency,
+      one_euro_beta, one_euro_derivative_cutoff, publish_period, publish_delay, incoming_command_timeout,
+      joint_limit_margin, collision_check_rate, max_joint_acceleration, max_joint_jerk, joint_state_estimator_alpha,
+      joint_state_estimator_beta, pose_linear_gain, pose_angular_gain, pose_max_linear_velocity,
+      pose_max_angular_velocity, drift_correction_gain, drift_correction_ik_period, drift_correction_ik_timeout,
+      null_space_joint_limit_gain, null_space_manipulability_gain, null_space_posture_gain;
+  std::vector<double> null_space_posture;
+  int low_pass_filter_order;
+  bool gazebo, collision_check, publish_joint_positions, publish_joint_velocities, publish_joint_accelerations,
+      smoothing, enforce_acceleration_limits, estimate_joint_states, coordinated_jogging, direct_input,
+      correct_drift, use_arena_allocator;
 };
 
+// The filter applied to joint positions and velocities, sampled once per publish_period
+FilterSpec getJointFilterSpec(const jog_arm_parameters& parameters);
+
+class JogCalcs;
+class CoordinatedJogCalcs;
+class CollisionCheck;
+
 /**
- * Class JogROSInterface - Instantiated in main(). Handles ROS subs & pubs and
- * creates the worker threads.
+ * Class JogROSInterface - Handles ROS subs & pubs and schedules the jogging
+ * calculations and collision checking as periodic tasks on an executor.
+ * Several move groups can be jogged at once. They share the robot model, the
+ * joint state subscriptions and the collision checking task. All state
+ * belongs to the instance, so several independently configured servers can
+ * run in one process, e.g. in a nodelet manager, and share one executor.
  */
 class JogROSInterface
 {
 public:
-  JogROSInterface();
+  // Parameters are read from each namespace, one per move group. Pass a robot model
+  // loader or an executor to share them with other servers, otherwise start() creates them.
+  JogROSInterface(const ros::NodeHandle& n, const std::vector<std::string>& parameter_namespaces,
+                  const std::shared_ptr<robot_model_loader::RobotModelLoader>& model_loader_ptr = nullptr,
+                  const std::shared_ptr<PeriodicTaskExecutor>& executor = nullptr);
+
+  ~JogROSInterface();
+
+  // Read parameters, then schedule the calculations and start the ROS subs & pubs.
+  // Returns false if the parameters are invalid or the executor could not start.
+  bool start();
+
+  // Call publishCommands() once per publish_period until ROS shuts down or stop() is called.
+  // Not needed if the owner calls publishCommands() itself, e.g. from a ros::Timer.
+  void run();
+
+  // Publish the most recent trajectory of every move group that is due this cycle. Does nothing unless started.
+  void publishCommands();
 
-  // Store the parameters that were read from ROS server
-  static struct jog_arm_parameters ros_parameters_;
+  // Stop the calculations and wait for any that are running
+  void stop();
+
+  // The parameters that were read from ROS server, one entry per move group
+  const std::vector<jog_arm_parameters>& getParameters() const;
 
 private:
-  // ROS subscriber callbacks
-  void deltaCartesianCmdCB(const geometry_msgs::TwistStampedConstPtr& msg);
-  void deltaJointCmdCB(const jog_msgs::JogJointConstPtr& msg);
-  void jointsCB(const sensor_msgs::JointStateConstPtr& msg);
+  // ROS subscriber callbacks. group indexes ros_parameters_ and shared_variables_.
+  void deltaCartesianCmdCB(const geometry_msgs::TwistStampedConstPtr& msg, std::size_t group);
+  void deltaJointCmdCB(const jog_msgs::JogJointConstPtr& msg, std::size_t group);
+  void jointsCB(const boost::shared_ptr<const ParsedJointState>& msg, const std::string& topic);
+  // Routed to the move group named in the msg
+  void deltaFrameCmdCB(const jog_msgs::JogFrameConstPtr& msg, const std::string& topic);
+  void poseCmdCB(const geometry_msgs::PoseStampedConstPtr& msg, std::size_t group);
+  void coordinatedCmdCB(const geometry_msgs::TwistStampedConstPtr& msg, std::size_t pair, bool relative);
 
-  bool readParameters(ros::NodeHandle& n);
+  // Input read straight from a joystick device. Passes the mapped commands to the callbacks above.
+  // Returns true while they command motion.
+  bool directInputCB(const std::vector<float>& axes, const std::vector<int32_t>& buttons, std::size_t group);
 
-  // Jogging calculation thread
-  static void* jogCalcThread(void* thread_id);
+  // A command for one move group ends coordinated jogging of its pair
+  void leaveCoordinatedJogging(std::size_t group);
 
-  // Collision checking thread
-  static void* CollisionCheckThread(void* thread_id);
+  bool readParameters(ros::NodeHandle& n, const std::string& parameter_ns, jog_arm_parameters& parameters);
 
-  // Variables to share between threads
-  static struct jog_arm_shared shared_variables_;
+  // Returns the number of parameters that could not be read
+  std::size_t readParameterValues(ros::NodeHandle& n, const std::string& parameter_ns,
+                                  jog_arm_parameters& parameters);
 
-  // static robot_model_loader::RobotModelLoader *model_loader_ptr_;
-  static std::unique_ptr<robot_model_loader::RobotModelLoader> model_loader_ptr_;
-};
+  // Input checking. Logs a warning and returns false if a parameter is invalid.
+  static bool validateParameters(const jog_arm_parameters& parameters);
 
-/**
- * Class LowPassFilter - Filter the joint velocities to avoid jerky motion.
- */
-class LowPassFilter
-{
-public:
-  explicit LowPassFilter(double low_pass_filter_coeff);
-  double filter(double new_msrmt);
-  void reset(double data);
-  double filter_coeff_ = 10.;
+  // The name of a parameter that differs, but can't change while running, or an empty string
+  static std::string getFixedParameterChange(const jog_arm_parameters& current, const jog_arm_parameters& reloaded);
 
-private:
-  double prev_msrmts_[3] = { 0., 0., 0. };
-  double prev_filtered_msrmts_[2] = { 0., 0. };
-};
+  // Re-read every parameter namespace. Share the new parameters only if all of them are valid.
+  bool reloadParametersCB(std_srvs::Trigger::Request& req, std_srvs::Trigger::Response& res);
 
-LowPassFilter::LowPassFilter(const double low_pass_filter_coeff)
-{
-  filter_coeff_ = low_pass_filter_coeff;
-}
+  // Share a copy of ros_parameters_[group] with the worker threads
+  void shareParameters(std::size_t group);
 
-void LowPassFilter::reset(const double data)
-{
-  prev_msrmts_[0] = data;
-  prev_msrmts_[1] = data;
-  prev_msrmts_[2] = data;
+  // The latest shared parameters of a move group. Unlike ros_parameters_, safe to read from any thread.
+  const jog_arm_parameters& getSharedParameters(std::size_t group) const;
 
-  prev_filtered_msrmts_[0] = data;
-  prev_filtered_msrmts_[1] = data;
-}
+  // Pause the task that jogs these move groups, unless a command arrived. Called by the task itself.
+  void pauseJogging(const std::vector<std::size_t>& groups);
 
-double LowPassFilter::filter(const double new_msrmt)
-{
-  // Push in the new measurement
-  prev_msrmts_[2] = prev_msrmts_[1];
-  prev_msrmts_[1] = prev_msrmts_[0];
-  prev_msrmts_[0] = new_msrmt;
+  // Resume the task that jogs a move group, e.g. because a command arrived
+  void resumeJogging(std::size_t group);
 
-  double new_filtered_msrmt = (1 / (1 + filter_coeff_ * filter_coeff_ + 1.414 * filter_coeff_)) *
-                              (prev_msrmts_[2] + 2 * prev_msrmts_[1] + prev_msrmts_[0] -
-                               (filter_coeff_ * filter_coeff_ - 1.414 * filter_coeff_ + 1) * prev_filtered_msrmts_[1] -
-                               (-2 * filter_coeff_ * filter_coeff_ + 2) * prev_filtered_msrmts_[0]);
+  // True if the latest command of a move group is non-zero and not timed out
+  bool hasActiveCommand(std::size_t group);
 
-  // Store the new filtered measurement
-  prev_filtered_msrmts_[1] = prev_filtered_msrmts_[0];
-  prev_filtered_msrmts_[0] = new_filtered_msrmt;
+  // True if every move group is idle, so there is nothing to publish
+  bool isIdle();
 
-  return new_filtered_msrmt;
-}
+  // Read the low_pass_filter block, or convert the older low_pass_filter_coeff
+  std::size_t readFilterParameters(ros::NodeHandle& n, const std::string& parameter_ns,
+                                   jog_arm_parameters& parameters);
+
+  // Warn about tasks that missed their deadlines since the last report
+  void reportTelemetry();
+
+  ros::NodeHandle nh_;
+  std::vector<std::string> parameter_namespaces_;
+
+  // Store the parameters that were read from ROS server, one entry per move group.
+  // A reload writes them, so callbacks read getSharedParameters() instead.
+  std::vector<jog_arm_parameters> ros_parameters_;
+
+  // Every parameter block shared with the worker threads. A thread may still read an older
+  // block after a reload, so they are only freed by stop().
+  std::deque<std::unique_ptr<const jog_arm_parameters>> shared_parameters_;
+  ros::ServiceServer reload_parameters_server_;
+
+  // Variables to share between threads, one entry per move group.
+  // A deque, so entries don't move while the threads hold references to them.
+  std::deque<jog_arm_shared> shared_variables_;
+
+  // Move groups that are jogged together, their commands, and each group's partner (or -1)
+  std::vector<std::pair<std::size_t, std::size_t>> coordinated_pairs_;
+  std::deque<jog_arm_coordinated_shared> coordinated_shared_variables_;
+  std::vector<int> partner_groups_;
+
+  std::shared_ptr<robot_model_loader::RobotModelLoader> model_loader_ptr_;
+
+  // One TF buffer serves every move group
+  std::unique_ptr<tf::TransformListener> transform_listener_;
+
+  std::shared_ptr<PeriodicTaskExecutor> executor_;
+  std::vector<std::unique_ptr<JogCalcs>> jog_calcs_;
+  std::vector<std::unique_ptr<CoordinatedJogCalcs>> coordinated_jog_calcs_;
+  std::unique_ptr<CollisionCheck> collision_check_;
+  // Executor tasks for the jogging calculations and collision checking
+  std::vector<std::size_t> task_ids_;
+  std::vector<uint64_t> reported_overruns_;
+  std::size_t collision_check_task_id_ = 0;
+
+  // Jogging tasks are paused while nobody jogs. Collision checking and telemetry are paused
+  // while every move group is idle. jog_task_ids_[group] is the task that jogs a move group.
+  std::vector<std::size_t> jog_task_ids_;
+  std::vector<bool> idle_groups_;
+  pthread_mutex_t idle_mutex_;
+  std::size_t telemetry_task_id_ = 0;
+  bool started_ = false;
+
+  // One per joint topic. Declared before subscribers_, which use them.
+  std::map<std::string, std::unique_ptr<JointStateParser>> joint_state_parsers_;
+  // Where each move group's joints are in the frames parsed from its joint topic
+  std::vector<std::vector<std::size_t>> joint_frame_indices_;
+
+  std::vector<ros::Subscriber> subscribers_;
+
+  // Joysticks read by the server itself, with the mapping of each move group that enables direct_input
+  std::vector<JoyMapping> direct_input_mappings_;
+  std::vector<std::unique_ptr<EvdevJoystick>> direct_inputs_;
+  std::vector<ros::Publisher> outgoing_cmd_pubs_;
+  // The last trajectory of each move group, reused so publishing does not allocate
+  std::vector<JogTrajectory> outgoing_trajs_;
+  // The same trajectories serialized. Only the stamp and numbers are rewritten each cycle.
+  std::vector<SerializedTrajectory> serialized_trajs_;
+
+  // Publishing runs at the fastest publish_period. Slower move groups publish every few cycles.
+  double min_publish_period_ = 0;
+  std::vector<unsigned int> publish_divisors_;
+  unsigned int publish_cycle_ = 0;
+};
 
 /**
  * Class JogCalcs - Perform the Jacobian calculations.
@@ -199,19 +351,92 @@ class JogCalcs
 {
 public:
   JogCalcs(const jog_arm_parameters& parameters, jog_arm_shared& shared_variables,
-           const std::unique_ptr<robot_model_loader::RobotModelLoader>& model_loader_ptr);
+           const std::shared_ptr<robot_model_loader::RobotModelLoader>& model_loader_ptr,
+           tf::TransformListener& listener);
+
+  // One cycle of jogging calculations. Returns without waiting if there is
+  // nothing to do yet. Call it once per publish_period.
+  void step();
+
+  // True if there is no command to follow and any halt is complete. Nothing changes until
+  // a new command arrives.
+  bool isIdle() const;
+
+  // Call before the calculations are paused. They restart from the robot's joints when resumed.
+  void enterIdle();
 
 protected:
+  friend class CoordinatedJogCalcs;
+
   ros::NodeHandle nh_;
 
-  moveit::planning_interface::MoveGroupInterface move_group_;
+  JointStateFrame incoming_joints_;
 
-  sensor_msgs::JointState incoming_jts_;
+  // Jog link_name, or the tip if it is empty. avoid_collisions slows down near collisions.
+  bool cartesianJogCalcs(const geometry_msgs::TwistStamped& cmd, jog_arm_shared& shared_variables,
+                         const std::string& link_name, bool avoid_collisions);
 
-  bool cartesianJogCalcs(const geometry_msgs::TwistStamped& cmd, jog_arm_shared& shared_variables);
+  // Move the tip toward a target pose, with a velocity proportional to the error from its current pose
+  bool poseTrackingJogCalcs(const geometry_msgs::PoseStamped& cmd, jog_arm_shared& shared_variables);
+
+  // Convert a displacement of a link in the planning frame, for this publish_period, to joint increments.
+  // correct_drift keeps the link on the pose that the displacements integrate to.
+  bool cartesianDeltaJogCalcs(const Eigen::VectorXd& delta_x, jog_arm_shared& shared_variables,
+                              const std::string& link_name, bool avoid_collisions, bool correct_drift);
 
   bool jointJogCalcs(const jog_msgs::JogJoint& cmd, jog_arm_shared& shared_variables);
 
+  // Read the joints and the command flags. False if there is nothing to do yet.
+  bool beginStep();
+
+  // Halt if needed, then smooth, limit and share the new trajectory
+  void finishStep();
+
+  // Check for nan's and, for unitless commands, components beyond [-1:1]
+  bool isValidCartesianCommand(const geometry_msgs::TwistStamped& cmd) const;
+
+  // Needs kinematic_state_ at the current joints
+  bool transformToPlanningFrame(const geometry_msgs::TwistStamped& cmd, geometry_msgs::TwistStamped& twist_cmd);
+
+  // Transform from a frame to the planning frame. Links moved by the move group are taken from
+  // kinematic_state_, other frames from TF.
+  bool getReferenceTransform(const std::string& frame_id, Eigen::Isometry3d& transform);
+
+  // Transform of a frame off the move group, from TF. Cached per frame ID.
+  bool lookupReferenceTransform(const std::string& frame_id, Eigen::Isometry3d& transform);
+
+  struct LinkJacobian
+  {
+    const robot_model::LinkModel* link;
+    // The joints it was computed at
+    std::vector<double> positions;
+    Eigen::MatrixXd jacobian;
+  };
+
+  // The Jacobian of a link that the move group moves, or of its tip if link_name is empty, at jt_state_.
+  // Needs kinematic_state_ at the current joints. Null if the move group doesn't move the link.
+  const LinkJacobian* getLinkJacobian(const std::string& link_name);
+
+  // Joint increments that move the link back onto anchor_pose_, across the commanded direction.
+  // Starts a new anchor if there is none.
+  Eigen::VectorXd getDriftCorrection(const Eigen::VectorXd& delta_x, const LinkJacobian& link_jacobian,
+                                     const Eigen::MatrixXd& pseudo_inverse);
+
+  // Joint increments toward the null_space objectives that don't move the link. matrix_v and
+  // singular_values are from the SVD of its Jacobian. Zero unless the move group is redundant.
+  Eigen::VectorXd getNullSpaceMotion(const Eigen::MatrixXd& matrix_v, const Eigen::VectorXd& singular_values,
+                                     const LinkJacobian& link_jacobian);
+
+  // Gradient of the log of the link's manipulability, by finite differences
+  Eigen::VectorXd getManipulabilityGradient(const Eigen::VectorXd& singular_values, const LinkJacobian& link_jacobian);
+
+  // Add joint increments, filter them and compose new_traj_.
+  // velocity_scale slows down near singularities and collisions.
+  bool applyJointIncrements(const Eigen::VectorXd& delta_theta, double velocity_scale);
+
+  // Copy the latest joint msg from the shared variables
+  void readIncomingJoints(jog_arm_shared& shared_variables);
+
   // Parse the incoming joint msg for the joints of our MoveGroup
   bool updateJoints();
 
@@ -224,7 +449,8 @@ protected:
   // This pseudoinverse calculation is more stable near stabilities. See Golub, 1965, "Calculating the Singular Values..."
   Eigen::MatrixXd pseudoInverse(const Eigen::MatrixXd& u_matrix, const Eigen::MatrixXd& v_matrix, const Eigen::MatrixXd& s_diagonals) const;
 
-  void enforceJointVelocityLimits(Eigen::VectorXd& calculated_joint_vel);
+  // Returns the factor the increments were scaled by
+  double enforceJointVelocityLimits(Eigen::VectorXd& calculated_joint_vel);
   bool addJointIncrements(sensor_msgs::JointState& output, const Eigen::VectorXd& increments) const;
 
   // Reset the data stored in low-pass filters so the trajectory won't jump when
@@ -233,51 +459,214 @@ protected:
 
   // Avoid a singularity or other issue.
   // Needs to be handled differently for position vs. velocity control
-  void halt(trajectory_msgs::JointTrajectory& jt_traj);
+  void halt(JogTrajectory& jt_traj);
+
+  // Publish on warning_topic, if active changed
+  void publishWarning(bool active);
+
+  // Report a reason for slowing down or halting this cycle. The largest code wins.
+  void raiseStatus(uint8_t code, const std::string& joint_name = "", const std::string& link_name = "");
 
-  void publishWarning(bool active) const;
+  // Report what collision checking found, if this cycle's motion avoids collisions
+  void raiseCollisionStatus();
 
-  bool checkIfJointsWithinBounds(trajectory_msgs::JointTrajectory_<std::allocator<void>>& new_jt_traj);
+  // Publish this cycle's status if it changed, then start the next cycle from OK
+  void publishStatus();
+
+  bool checkIfJointsWithinBounds(JogTrajectory& new_jt_traj);
 
   // Possibly calculate a velocity scaling factor, due to proximity of
   // singularity and direction of motion
-  double decelerateForSingularity(Eigen::MatrixXd jacobian, const Eigen::VectorXd commanded_velocity);
+  // The Jacobian is of link, or of the tip if link is null.
+  double decelerateForSingularity(Eigen::MatrixXd jacobian, const Eigen::VectorXd commanded_velocity,
+                                  const robot_model::LinkModel* link = nullptr);
 
   // Apply velocity scaling for proximity of collisions and singularities
-  bool applyVelocityScaling(jog_arm_shared& shared_variables, trajectory_msgs::JointTrajectory& new_jt_traj,
-                            const Eigen::VectorXd& delta_theta, double singularity_scale);
+  bool applyVelocityScaling(JogTrajectory& new_jt_traj, const Eigen::VectorXd& delta_theta, double velocity_scale);
 
-  trajectory_msgs::JointTrajectory composeOutgoingMessage(sensor_msgs::JointState& joint_state,
-                                                          const ros::Time& stamp) const;
+  // Built in the arena that new_traj_ is not using, which is reset first
+  JogTrajectory composeOutgoingMessage(sensor_msgs::JointState& joint_state, const ros::Time& stamp);
 
   void lowPassFilterVelocities(const Eigen::VectorXd& joint_vel);
 
   void lowPassFilterPositions();
 
-  void insertRedundantPointsIntoTrajectory(trajectory_msgs::JointTrajectory& trajectory, int count) const;
+  void insertRedundantPointsIntoTrajectory(JogTrajectory& trajectory, int count) const;
+
+  // Limit the velocity, acceleration and jerk of the outgoing trajectory
+  void smoothOutgoingTrajectory(JogTrajectory& jt_traj);
+
+  // Calculate accelerations from consecutive outgoing velocities and, optionally, scale
+  // them uniformly to stay within the robot's acceleration limits
+  void applyAccelerationLimits(JogTrajectory& jt_traj);
+
+  // Forget the previous outgoing command, e.g. after not publishing for a while
+  void resetAccelerationEstimate();
+
+  // Switch to reloaded parameters. Filters, smoothing and estimation carry on from their current state.
+  void applyParameters(const jog_arm_parameters& parameters);
 
   const robot_state::JointModelGroup* joint_model_group_;
 
   robot_state::RobotStatePtr kinematic_state_;
 
   sensor_msgs::JointState jt_state_, original_jts_;
-  trajectory_msgs::JointTrajectory new_traj_;
-
-  tf::TransformListener listener_;
-
-  std::vector<jog_arm::LowPassFilter> velocity_filters_;
-  std::vector<jog_arm::LowPassFilter> position_filters_;
+  JogTrajectory new_traj_;
+
+  // new_traj_ lives in one arena while the next trajectory is composed in the other
+  CycleArena message_arenas_[2];
+  std::size_t message_arena_index_ = 0;
+
+  tf::TransformListener& listener_;
+
+  // Looked up once per link name. Recomputed only when the joints moved.
+  std::map<std::string, LinkJacobian> link_jacobians_;
+
+  struct ReferenceTransform
+  {
+    ros::WallTime lookup_time;
+    Eigen::Isometry3d transform;
+  };
+  // Frames off the move group, by frame ID
+  std::map<std::string, ReferenceTransform> reference_transforms_;
+
+  // The parent link of the move group. Links moved by the move group are first expressed in it.
+  std::string group_base_frame_;
+
+  // The pose, in the planning frame, that Cartesian commands have moved anchor_link_ to.
+  // Dropped whenever jogging stops or halts.
+  Eigen::Isometry3d anchor_pose_;
+  std::string anchor_link_;
+  bool anchor_valid_ = false;
+  ros::WallTime last_ik_anchor_time_;
+  // The move group has a kinematics solver for drift_correction/ik_period
+  bool ik_available_ = false;
+
+  std::unique_ptr<jog_arm::LowPassFilterBank> velocity_filters_;
+  std::unique_ptr<jog_arm::LowPassFilterBank> position_filters_;
+
+  std::unique_ptr<jog_arm::JerkLimitedSmoother> smoother_;
+
+  // From the robot model. Zero if a joint has no acceleration limit.
+  Eigen::VectorXd acceleration_limits_;
+  // The middle and half the width of each joint's position range. Zero width if it has no limits.
+  Eigen::VectorXd joint_mid_positions_, joint_half_ranges_;
+  // The joints when jogging started, held if null_space/posture is empty
+  Eigen::VectorXd start_posture_;
+  // The last outgoing command, for acceleration estimates
+  Eigen::VectorXd prev_outgoing_positions_, prev_outgoing_velocities_;
+
+  std::unique_ptr<jog_arm::JointStateEstimator> joint_state_estimator_;
+  std::vector<double> measured_velocity_;
 
   ros::Publisher warning_pub_;
+  bool warning_published_ = false, last_warning_ = false;
+
+  // Latched. status_ collects this cycle's reasons, published_status_ is what subscribers have.
+  ros::Publisher status_pub_;
+  jog_msgs::JogStatus status_, published_status_;
+  bool status_published_ = false;
 
   jog_arm_parameters parameters_;
+  // The shared block parameters_ was copied from
+  const jog_arm_parameters* shared_parameters_;
+
+  jog_arm_shared& shared_variables_;
+
+  // Seeded from the first complete joint msg
+  bool joints_initialized_ = false;
+  bool received_first_command_ = false;
+
+  // Track the number of cycles during which motion has not occurred.
+  // Will avoid re-publishing zero velocities endlessly.
+  int zero_velocity_count_ = 0;
+
+  // Copied from the shared variables at the start of each cycle
+  bool zero_cartesian_traj_flag_ = true;
+  bool zero_joint_traj_flag_ = true;
 };
 
-class CollisionCheckThread
+/**
+ * Class CoordinatedJogCalcs - Jogs two move groups as one, e.g. two arms
+ * holding an object. A coordinated command is a twist of the object, halfway
+ * between the end effectors, and a twist of the second end effector relative
+ * to the first. Both move groups are solved in one step with their stacked
+ * Jacobian, so their relative pose is kept. Without a coordinated command,
+ * each move group jogs on its own.
+ */
+class CoordinatedJogCalcs
+{
+public:
+  CoordinatedJogCalcs(JogCalcs& first, JogCalcs& second, jog_arm_coordinated_shared& shared_variables);
+
+  // One cycle of jogging calculations for both move groups
+  void step();
+
+  bool isIdle() const;
+
+private:
+  bool isCoordinated(jog_arm_shared& shared_variables) const;
+
+  bool coordinatedJogCalcs(const geometry_msgs::TwistStamped& object_cmd,
+                           const geometry_msgs::TwistStamped& relative_cmd);
+
+  JogCalcs& first_;
+  JogCalcs& second_;
+  jog_arm_coordinated_shared& shared_variables_;
+
+  // Columns of the stacked Jacobian. A joint in both move groups gets one column.
+  std::vector<std::string> joint_names_;
+  std::vector<std::size_t> first_columns_, second_columns_;
+};
+
+/**
+ * Class CollisionCheck - Scales down the velocity of each move group that has
+ * collision_check set, as it nears a collision. One planning scene serves all
+ * of them.
+ */
+class CollisionCheck
 {
 public:
-  CollisionCheckThread(const jog_arm_parameters& parameters, jog_arm_shared& shared_variables,
-                       const std::unique_ptr<robot_model_loader::RobotModelLoader>& model_loader_ptr);
+  CollisionCheck(const std::vector<jog_arm_parameters>& parameters, std::deque<jog_arm_shared>& shared_variables,
+                 const std::vector<std::pair<std::size_t, std::size_t>>& coordinated_pairs,
+                 const std::shared_ptr<robot_model_loader::RobotModelLoader>& model_loader_ptr);
+
+  // False if no move group has collision_check set
+  bool isEnabled() const;
+
+  // Call step() this often [s], for the fastest collision_check_rate
+  double getPeriod() const;
+
+  // Check collisions once and share the velocity scales
+  void step();
+
+private:
+  std::deque<jog_arm_shared>& shared_variables_;
+
+  // The move groups to check, and their latest parameters
+  std::vector<std::size_t> groups_;
+  std::vector<const jog_arm_parameters*> parameters_;
+  std::vector<const robot_state::JointModelGroup*> joint_model_groups_;
+  double period_ = 0;
+
+  std::unique_ptr<planning_scene::PlanningScene> planning_scene_;
+  std::unique_ptr<moveit::planning_interface::PlanningSceneInterface> planning_scene_interface_;
+  // One query per move group. Move groups that are jogged together share a query of
+  // the whole robot. channels are indices into groups_.
+  struct CollisionQuery
+  {
+    collision_detection::CollisionRequest request;
+    std::vector<std::size_t> channels;
+  };
+  std::vector<CollisionQuery> collision_queries_;
+  collision_detection::CollisionResult collision_result_;
+
+  // One channel per move group
+  std::unique_ptr<LowPassFilterBank> velocity_scale_filters_;
+  Eigen::ArrayXd velocity_scales_;
+  // jog_msgs::JogStatus code and a link in collision, per move group
+  std::vector<uint8_t> collision_status_;
+  std::vector<std::string> collision_links_;
 };
 
 }  // namespace jog_arm
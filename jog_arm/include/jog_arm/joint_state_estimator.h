@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : joint_state_estimator.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Filtered, latency-compensated joint positions and velocities.
+
+#ifndef JOG_ARM_JOINT_STATE_ESTIMATOR_H
+#define JOG_ARM_JOINT_STATE_ESTIMATOR_H
+
+#include <Eigen/Core>
+#include <string>
+
+namespace jog_arm
+{
+/**
+ * Class JointStateEstimator - An alpha-beta filter per joint. Measurements
+ * correct the estimate at their own timestamps, then the estimate is
+ * extrapolated to the time it is used, which hides the age of joint_states.
+ * Changes in the commanded velocity are fed forward, because the robot is
+ * expected to follow them before any measurement shows it.
+ */
+class JointStateEstimator
+{
+public:
+  JointStateEstimator(std::size_t num_joints, double alpha, double beta);
+
+  // Return an error message if the gains make the filter unstable, or an empty string
+  static std::string validate(double alpha, double beta);
+
+  // Change the gains. The estimate is kept.
+  void setGains(double alpha, double beta);
+
+  // Correct the estimate with a measurement taken at stamp [s]. velocity may be null.
+  void update(double stamp, const double* position, const double* velocity);
+
+  // Tell the estimator what velocity was just commanded
+  void setCommandedVelocity(const Eigen::VectorXd& commanded_velocity);
+
+  // Extrapolate the estimate to time [s]
+  void predict(double time, double* position, double* velocity) const;
+
+  bool isInitialized() const
+  {
+    return initialized_;
+  }
+
+  double lastStamp() const
+  {
+    return stamp_;
+  }
+
+private:
+  void initialize(double stamp, const double* position, const double* velocity);
+
+  double alpha_, beta_;
+
+  bool initialized_ = false;
+  double stamp_ = 0;
+
+  Eigen::VectorXd position_, velocity_, commanded_velocity_;
+};
+}  // namespace jog_arm
+
+#endif  // JOG_ARM_JOINT_STATE_ESTIMATOR_H
@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : joint_state_parser.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Reads move group joints straight from serialized sensor_msgs/JointState msgs.
+
+#ifndef JOG_ARM_JOINT_STATE_PARSER_H
+#define JOG_ARM_JOINT_STATE_PARSER_H
+
+#include <pthread.h>
+#include <ros/message_traits.h>
+#include <ros/serialization.h>
+#include <ros/time.h>
+#include <sensor_msgs/JointState.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace jog_arm
+{
+// Most joints that one joint topic can be parsed for
+static const std::size_t MAX_FRAME_JOINTS = 64;
+
+// Joint positions and velocities from one msg, in a fixed order. Cheap to copy.
+struct JointStateFrame
+{
+  ros::Time stamp;
+  std::size_t num_joints = 0;
+
+  // Whether the msg had every joint
+  bool complete = false;
+
+  // Which joints the msg had. The position and velocity of the others are not valid.
+  bool found[MAX_FRAME_JOINTS] = {};
+
+  // Not every driver reports velocity
+  bool has_velocity = false;
+
+  double position[MAX_FRAME_JOINTS] = {};
+  double velocity[MAX_FRAME_JOINTS] = {};
+};
+
+/**
+ * Class JointStateParser - Extracts chosen joints from serialized
+ * sensor_msgs/JointState msgs into a JointStateFrame. Where each joint sits
+ * in the msg is looked up once. While later msgs carry byte-for-byte the
+ * same name list, the names are compared with one memcmp and no strings are
+ * built. Efforts are skipped. parse() and addJoints() lock a mutex, so a
+ * parser can be used from several spinner threads.
+ */
+class JointStateParser
+{
+public:
+  JointStateParser();
+
+  ~JointStateParser();
+
+  JointStateParser(const JointStateParser&) = delete;
+  JointStateParser& operator=(const JointStateParser&) = delete;
+
+  // Parse these joints as well. frame_indices receives where each one lands in the frame.
+  // False if the frame would exceed MAX_FRAME_JOINTS.
+  bool addJoints(const std::vector<std::string>& names, std::vector<std::size_t>& frame_indices);
+
+  // False if the msg is malformed. frame.found tells which joints the msg had.
+  bool parse(const uint8_t* data, uint32_t length, JointStateFrame& frame);
+
+private:
+  // parse(), with mutex_ locked
+  bool parseLocked(const uint8_t* data, uint32_t length, JointStateFrame& frame);
+
+  // Find the joints in the name list at data
+  void indexNames(const uint8_t* data, uint32_t length, uint32_t count);
+
+  // The joints to extract, in frame order
+  std::vector<std::string> names_;
+
+  // The serialized name list that msg_indices_ was computed for
+  std::vector<uint8_t> msg_names_;
+
+  // Where each joint is in the msg. -1 if missing.
+  std::vector<int> msg_indices_;
+
+  // Guards names_, msg_names_ and msg_indices_
+  pthread_mutex_t mutex_;
+};
+
+// A sensor_msgs/JointState deserialized by a JointStateParser
+struct ParsedJointState
+{
+  explicit ParsedJointState(JointStateParser* parser = nullptr) : parser(parser)
+  {
+  }
+
+  JointStateParser* parser;
+  bool valid = false;
+  JointStateFrame frame;
+};
+}  // namespace jog_arm
+
+namespace ros
+{
+namespace message_traits
+{
+template <>
+struct IsMessage<jog_arm::ParsedJointState> : TrueType
+{
+};
+
+template <>
+struct MD5Sum<jog_arm::ParsedJointState>
+{
+  static const char* value()
+  {
+    return MD5Sum<sensor_msgs::JointState>::value();
+  }
+
+  static const char* value(const jog_arm::ParsedJointState&)
+  {
+    return value();
+  }
+};
+
+template <>
+struct DataType<jog_arm::ParsedJointState>
+{
+  static const char* value()
+  {
+    return DataType<sensor_msgs::JointState>::value();
+  }
+
+  static const char* value(const jog_arm::ParsedJointState&)
+  {
+    return value();
+  }
+};
+
+template <>
+struct Definition<jog_arm::ParsedJointState>
+{
+  static const char* value()
+  {
+    return Definition<sensor_msgs::JointState>::value();
+  }
+
+  static const char* value(const jog_arm::ParsedJointState&)
+  {
+    return value();
+  }
+};
+}  // namespace message_traits
+
+namespace serialization
+{
+// Subscribe-only. The parser reads the msg where roscpp received it.
+template <>
+struct Serializer<jog_arm::ParsedJointState>
+{
+  template <typename Stream>
+  inline static void read(Stream& stream, jog_arm::ParsedJointState& msg)
+  {
+    msg.valid = msg.parser && msg.parser->parse(stream.getData(), stream.getLength(), msg.frame);
+  }
+};
+}  // namespace serialization
+}  // namespace ros
+
+#endif  // JOG_ARM_JOINT_STATE_PARSER_H
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : joy_mapping.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Maps joystick axes and buttons to jogging commands.
+
+#ifndef JOG_ARM_JOY_MAPPING_H
+#define JOG_ARM_JOY_MAPPING_H
+
+#include <ros/ros.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace jog_arm
+{
+// One command component, driven by an axis or by a pair of buttons
+struct JoyInputMapping
+{
+  // Index into the axes, or -1
+  int axis = -1;
+
+  // Indices into the buttons, or -1. They drive the component to +1 and -1.
+  int positive_button = -1;
+  int negative_button = -1;
+
+  // Inputs with a smaller magnitude read as zero. The rest of the range is stretched back to [0:1].
+  double deadzone = 0.;
+
+  // Response curve, sign(x)*|x|^exponent. 1 is linear. Larger gives finer control near the center.
+  double exponent = 1.;
+
+  // Multiplies the result. Negative to invert the direction.
+  double scale = 1.;
+
+  bool isMapped() const
+  {
+    return axis >= 0 || positive_button >= 0 || negative_button >= 0;
+  }
+
+  // The command component, in [-|scale|:|scale|]. Inputs the device does not have read as zero.
+  double apply(const std::vector<float>& axes, const std::vector<int32_t>& buttons) const;
+};
+
+// A whole device
+struct JoyMapping
+{
+  // linear x, y, z, then angular x, y, z
+  std::array<JoyInputMapping, 6> twist;
+
+  std::vector<std::string> joint_names;
+  std::vector<JoyInputMapping> joints;
+};
+
+// Parameter names of the twist components, in the order of JoyMapping::twist
+extern const std::array<std::string, 6> TWIST_COMPONENT_NAMES;
+
+// Return an error message if the mapping can't be used, or an empty string
+std::string validateJoyInputMapping(const JoyInputMapping& mapping);
+
+// Read twist/<component>/{axis, positive_button, negative_button, deadzone, exponent, scale} and, for each of
+// joint_names, joints/<name>/{...}. Unmapped components are always zero. Logs a warning and returns false if a
+// mapping is invalid.
+bool readJoyMapping(const ros::NodeHandle& n, JoyMapping& mapping);
+
+// Compute every command component. joint_deltas gets one entry per joint name.
+void applyJoyMapping(const JoyMapping& mapping, const std::vector<float>& axes, const std::vector<int32_t>& buttons,
+                     std::array<double, 6>& twist, std::vector<double>& joint_deltas);
+}  // namespace jog_arm
+
+#endif  // JOG_ARM_JOY_MAPPING_H
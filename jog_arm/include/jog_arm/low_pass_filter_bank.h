@@ -0,0 +1,158 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : low_pass_filter_bank.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Multi-channel low-pass filter for the jogging pipeline.
+
+#ifndef JOG_ARM_LOW_PASS_FILTER_BANK_H
+#define JOG_ARM_LOW_PASS_FILTER_BANK_H
+
+#include <Eigen/Core>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace jog_arm
+{
+enum class FilterType
+{
+  BUTTERWORTH,
+  CRITICALLY_DAMPED,
+  ONE_EURO
+};
+
+// Parse "butterworth", "critically_damped" or "one_euro"
+bool parseFilterType(const std::string& name, FilterType& type);
+
+// Describes the response of a LowPassFilterBank.
+struct FilterSpec
+{
+  FilterType type = FilterType::BUTTERWORTH;
+
+  // Butterworth: 1-4. Critically damped: 1-4. Ignored by one_euro.
+  int order = 2;
+
+  // -3dB frequency [Hz]. For one_euro, the cutoff when the signal is not changing.
+  double cutoff_frequency = 10.;
+
+  // Time between calls to filter() [s]
+  double sample_period = 0.01;
+
+  // one_euro only: how quickly the cutoff rises with the signal's rate of change
+  double one_euro_beta = 0.;
+
+  // one_euro only: cutoff of the filter on the rate of change [Hz]
+  double one_euro_derivative_cutoff = 1.;
+};
+
+/**
+ * Class LowPassFilterBank - Applies the same low-pass filter to many channels
+ * at once, e.g. every joint of a group. The filter history is stored as one
+ * array per tap so all channels are updated in a single vectorized pass.
+ * Butterworth and critically damped filters are built from cascaded
+ * second-order sections whose coefficients are computed once, here.
+ */
+class LowPassFilterBank
+{
+public:
+  LowPassFilterBank(std::size_t num_channels, const FilterSpec& spec);
+
+  // Return an error message if spec can't be realized, or an empty string
+  static std::string validate(const FilterSpec& spec);
+
+  // The cutoff frequency [Hz] that matches the old dimensionless
+  // low_pass_filter_coeff at a given sample period [s]
+  static double cutoffFromCoefficient(double low_pass_filter_coeff, double sample_period);
+
+  // Filter one sample per channel. input and output may alias.
+  void filter(const Eigen::Ref<const Eigen::ArrayXd>& input, Eigen::Ref<Eigen::ArrayXd> output);
+
+  // Filter a contiguous buffer of num_channels samples in place
+  void filter(double* data);
+
+  // Convenience for single-channel banks
+  double filter(double new_msrmt);
+
+  // Change the response while running. If the new filter has the same structure, the history is
+  // kept. Otherwise every channel restarts from a steady state at its last output. Either way the
+  // output continues without a jump.
+  void setSpec(const FilterSpec& spec);
+
+  // Set every channel to a steady state at data
+  void reset(double data);
+
+  // Set each channel to a steady state at its own value
+  void reset(const double* data);
+
+  std::size_t size() const
+  {
+    return static_cast<std::size_t>(work_.size());
+  }
+
+private:
+  // One biquad, direct form I. First-order sections have b2 = a2 = 0.
+  struct Section
+  {
+    double b0, b1, b2, a1, a2;
+
+    // Previous measurements and previous filtered measurements, one element per channel
+    Eigen::ArrayXd prev_msrmts_1, prev_msrmts_2;
+    Eigen::ArrayXd prev_filtered_msrmts_1, prev_filtered_msrmts_2;
+  };
+
+  // Compute the sections for spec_
+  void designSections();
+
+  void addFirstOrderSection(double cutoff_frequency);
+  void addSecondOrderSection(double cutoff_frequency, double q);
+  void addSection(Section& section);
+
+  void oneEuroFilter(Eigen::ArrayXd& data);
+
+  FilterSpec spec_;
+
+  std::vector<Section> sections_;
+
+  // one_euro state
+  Eigen::ArrayXd prev_filtered_msrmts_, prev_filtered_derivative_;
+
+  // Scratch space, so filtering does not allocate
+  Eigen::ArrayXd work_;
+};
+}  // namespace jog_arm
+
+#endif  // JOG_ARM_LOW_PASS_FILTER_BANK_H
@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : periodic_task_executor.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Runs periodic tasks on a small pool of worker threads.
+
+#ifndef JOG_ARM_PERIODIC_TASK_EXECUTOR_H
+#define JOG_ARM_PERIODIC_TASK_EXECUTOR_H
+
+#include <pthread.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace jog_arm
+{
+/**
+ * Class PeriodicTaskExecutor - Releases each task once per period onto a pool
+ * of worker threads. A free worker takes the most urgent ready job: the
+ * highest priority, then the earliest deadline. Of equally urgent jobs it
+ * prefers one it ran last, to stay in that core's cache. A task never runs
+ * concurrently with itself. If it is still queued or running when its next
+ * release is due, that release is skipped and counted as an overrun.
+ */
+class PeriodicTaskExecutor
+{
+public:
+  typedef std::function<void()> TaskFunction;
+
+  struct TaskStatistics
+  {
+    std::string name;
+    uint64_t runs = 0;
+    // Finished after the deadline, or skipped because the previous run was not done
+    uint64_t overruns = 0;
+    double max_duration = 0;
+    double total_duration = 0;
+  };
+
+  // Zero threads means one per core
+  explicit PeriodicTaskExecutor(std::size_t num_threads = 0);
+
+  ~PeriodicTaskExecutor();
+
+  // Run function every period [s]. It should finish within deadline [s] of its
+  // release, or within the period if deadline is zero. Ready tasks with a higher
+  // priority run first. Tasks can be added while the executor is running.
+  // Returns an ID for removeTask() and getStatistics().
+  std::size_t addTask(const std::string& name, double period, double deadline, int priority, TaskFunction function);
+
+  // Change how often a task runs, from its next release on. deadline works as in addTask().
+  void setPeriod(std::size_t task_id, double period, double deadline);
+
+  // Stop releasing the task and wait until it is not running
+  void removeTask(std::size_t task_id);
+
+  // Stop releasing the task until resumeTask(). Doesn't wait, so a task can pause itself.
+  void pauseTask(std::size_t task_id);
+
+  // Release the task again, right away
+  void resumeTask(std::size_t task_id);
+
+  bool start();
+
+  // Finish the running tasks and join the threads
+  void stop();
+
+  TaskStatistics getStatistics(std::size_t task_id) const;
+
+  std::size_t numThreads() const
+  {
+    return num_threads_;
+  }
+
+private:
+  struct Task
+  {
+    TaskStatistics statistics;
+    double period, deadline;
+    int priority;
+    TaskFunction function;
+    double next_release;
+    // The worker that ran it last. Preferred for the next run, to stay in that core's cache.
+    std::size_t worker = 0;
+    bool queued = false;
+    bool running = false;
+    bool paused = false;
+    bool removed = false;
+  };
+
+  struct Job
+  {
+    std::size_t task_id;
+    int priority;
+    double absolute_deadline;
+    // The worker that ran the task last
+    std::size_t worker;
+  };
+
+  struct WorkerArgs
+  {
+    PeriodicTaskExecutor* executor;
+    std::size_t worker;
+  };
+
+  static void* dispatchThread(void* executor);
+  static void* workerThread(void* args);
+
+  void dispatch();
+  void work(std::size_t worker);
+
+  // Release the tasks that are due. Returns the time of the next release.
+  double releaseDueTasks(double now);
+
+  // Take the most urgent ready job. ready_jobs_ must not be empty.
+  Job popJob(std::size_t worker);
+
+  std::size_t num_threads_;
+
+  // Guards tasks_, ready_jobs_ and stop_requested_
+  mutable pthread_mutex_t mutex_;
+  pthread_cond_t work_available_;
+  pthread_cond_t dispatch_wakeup_;
+  pthread_cond_t task_finished_;
+
+  // A deque, so tasks don't move while workers run them
+  std::deque<Task> tasks_;
+  // Released jobs that no worker has taken yet. Only a few tasks are ever ready, so a scan is cheap.
+  std::vector<Job> ready_jobs_;
+  bool stop_requested_ = false;
+  bool started_ = false;
+
+  std::vector<WorkerArgs> worker_args_;
+  std::vector<pthread_t> workers_;
+  pthread_t dispatcher_;
+  bool dispatcher_started_ = false;
+};
+}  // namespace jog_arm
+
+#endif  // JOG_ARM_PERIODIC_TASK_EXECUTOR_H
@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : robot_model_cache.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Load the robot model once per process.
+
+#ifndef JOG_ARM_ROBOT_MODEL_CACHE_H
+#define JOG_ARM_ROBOT_MODEL_CACHE_H
+
+#include <moveit/robot_model_loader/robot_model_loader.h>
+#include <ros/ros.h>
+
+#include <memory>
+#include <string>
+
+namespace jog_arm
+{
+/**
+ * Load the robot model from the URDF and SRDF on the parameter server. Models
+ * are cached by their URDF and SRDF, so servers in one process that
+ * jog the same robot share one model instead of parsing it again. Kinematics
+ * solver plugins are slow to load, so they are only loaded if asked for.
+ * Returns null if the robot description can't be read or parsed.
+ */
+std::shared_ptr<robot_model_loader::RobotModelLoader>
+loadRobotModel(const ros::NodeHandle& n, const std::string& robot_description = "robot_description",
+               bool load_kinematics_solvers = false);
+}  // namespace jog_arm
+
+#endif  // JOG_ARM_ROBOT_MODEL_CACHE_H
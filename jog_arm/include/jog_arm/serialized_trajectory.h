@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : serialized_trajectory.h
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Outgoing trajectories, kept in their wire format between cycles.
+
+#ifndef JOG_ARM_SERIALIZED_TRAJECTORY_H
+#define JOG_ARM_SERIALIZED_TRAJECTORY_H
+
+#include <jog_arm/cycle_arena.h>
+#include <ros/message_traits.h>
+#include <ros/serialization.h>
+#include <trajectory_msgs/JointTrajectory.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace jog_arm
+{
+// Outgoing trajectories. Built in a CycleArena if use_arena_allocator is set, otherwise on the heap.
+typedef trajectory_msgs::JointTrajectory_<ArenaAllocator<void>> JogTrajectory;
+typedef trajectory_msgs::JointTrajectoryPoint_<ArenaAllocator<void>> JogTrajectoryPoint;
+
+/**
+ * Class SerializedTrajectory - A JogTrajectory as it goes on the wire, to
+ * publish as a trajectory_msgs/JointTrajectory. From one cycle to the next
+ * only the stamp and the numbers change, so update() writes those in place.
+ * It serializes the whole message again only when the frame, the joint
+ * names or the array sizes differ from the last one.
+ */
+class SerializedTrajectory
+{
+public:
+  void update(const JogTrajectory& trajectory);
+
+  const uint8_t* data() const
+  {
+    return buffer_.data();
+  }
+
+  uint32_t size() const
+  {
+    return static_cast<uint32_t>(buffer_.size());
+  }
+
+private:
+  // Where the elements of each array of a point start, and its time_from_start
+  struct PointOffsets
+  {
+    std::size_t positions, velocities, accelerations, effort, time_from_start;
+  };
+
+  void serialize(const JogTrajectory& trajectory);
+
+  // Whether trajectory serializes to the same layout as buffer_
+  bool matchesLayout(const JogTrajectory& trajectory) const;
+
+  // Compare a string with the one serialized at offset, and step past it
+  template <class String>
+  bool matchesString(const String& string, std::size_t& offset) const
+  {
+    if (offset + 4 > buffer_.size() || readLength(offset) != string.size() ||
+        offset + 4 + string.size() > buffer_.size())
+      return false;
+    if (!string.empty() && std::memcmp(&buffer_[offset + 4], string.data(), string.size()) != 0)
+      return false;
+    offset += 4 + string.size();
+    return true;
+  }
+
+  // The length prefix of the string or array serialized at offset
+  uint32_t readLength(std::size_t offset) const;
+
+  template <class T>
+  void write(std::size_t offset, const T& value)
+  {
+    std::memcpy(&buffer_[offset], &value, sizeof(T));
+  }
+
+  template <class Array>
+  void writeArray(std::size_t offset, const Array& array)
+  {
+    if (!array.empty())
+      std::memcpy(&buffer_[offset], array.data(), array.size() * sizeof(double));
+  }
+
+  std::vector<uint8_t> buffer_;
+  std::vector<PointOffsets> point_offsets_;
+};
+}  // namespace jog_arm
+
+namespace ros
+{
+namespace message_traits
+{
+template <>
+struct IsMessage<jog_arm::SerializedTrajectory> : TrueType
+{
+};
+
+template <>
+struct MD5Sum<jog_arm::SerializedTrajectory>
+{
+  static const char* value()
+  {
+    return MD5Sum<trajectory_msgs::JointTrajectory>::value();
+  }
+
+  static const char* value(const jog_arm::SerializedTrajectory&)
+  {
+    return value();
+  }
+};
+
+template <>
+struct DataType<jog_arm::SerializedTrajectory>
+{
+  static const char* value()
+  {
+    return DataType<trajectory_msgs::JointTrajectory>::value();
+  }
+
+  static const char* value(const jog_arm::SerializedTrajectory&)
+  {
+    return value();
+  }
+};
+
+template <>
+struct Definition<jog_arm::SerializedTrajectory>
+{
+  static const char* value()
+  {
+    return Definition<trajectory_msgs::JointTrajectory>::value();
+  }
+
+  static const char* value(const jog_arm::SerializedTrajectory&)
+  {
+    return value();
+  }
+};
+}  // namespace message_traits
+
+namespace serialization
+{
+// Publishing copies the bytes as they are
+template <>
+struct Serializer<jog_arm::SerializedTrajectory>
+{
+  template <typename Stream>
+  inline static void write(Stream& stream, const jog_arm::SerializedTrajectory& trajectory)
+  {
+    std::memcpy(stream.advance(trajectory.size()), trajectory.data(), trajectory.size());
+  }
+
+  inline static uint32_t serializedLength(const jog_arm::SerializedTrajectory& trajectory)
+  {
+    return trajectory.size();
+  }
+};
+}  // namespace serialization
+}  // namespace ros
+
+#endif  // JOG_ARM_SERIALIZED_TRAJECTORY_H
@@ -0,0 +1,211 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : async_log.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Logging that never blocks the jogging calculations.
+
+#include <jog_arm/async_log.h>
+#include <sched.h>
+#include <time.h>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+
+namespace jog_arm
+{
+// How often the logging thread looks for messages [ns]
+static const long DRAIN_PERIOD_NS = 50000000;
+
+static int64_t steadyTimeNs()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+AsyncLogSite::AsyncLogSite(const ros::console::Level level, const double period, const char* name, const char* file,
+                           const int line, const char* function)
+  : level(level)
+  , period_ns(static_cast<int64_t>(period * 1e9))
+  , name(name)
+  , file(file)
+  , line(line)
+  , function(function)
+  , next_time_ns(0)
+  , suppressed(0)
+  , location{ false, false, ros::console::levels::Count, nullptr }
+{
+}
+
+AsyncLog& AsyncLog::instance()
+{
+  // Leaked on purpose. A static object would be destroyed at exit, while other threads may still log.
+  static AsyncLog* const log = new AsyncLog();
+  return *log;
+}
+
+AsyncLog::AsyncLog() : records_(new Record[QUEUE_CAPACITY]), enqueue_position_(0), dropped_(0), stop_(false)
+{
+  for (std::size_t i = 0; i < QUEUE_CAPACITY; ++i)
+    records_[i].sequence.store(i, std::memory_order_relaxed);
+
+  if (pthread_create(&thread_, nullptr, &AsyncLog::drainThread, this))
+    ROS_ERROR("Could not start the jog_arm logging thread. Hot-path messages will not be logged.");
+  else
+    thread_started_ = true;
+}
+
+void AsyncLog::stop()
+{
+  stop_.store(true, std::memory_order_release);
+  if (thread_started_)
+    pthread_join(thread_, nullptr);
+  thread_started_ = false;
+}
+
+void AsyncLog::log(AsyncLogSite& site, const char* format, ...)
+{
+  // Rate limit. If another thread logs from this site at the same moment, only one succeeds.
+  const int64_t now = steadyTimeNs();
+  int64_t next_time = site.next_time_ns.load(std::memory_order_relaxed);
+  if (now < next_time ||
+      !site.next_time_ns.compare_exchange_strong(next_time, now + site.period_ns, std::memory_order_relaxed))
+  {
+    site.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // Claim a record. The queue is full if the consumer hasn't released the one at this position.
+  Record* record;
+  std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+  while (true)
+  {
+    record = &records_[position & (QUEUE_CAPACITY - 1)];
+    const std::size_t sequence = record->sequence.load(std::memory_order_acquire);
+    const std::ptrdiff_t difference =
+        static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+    if (difference == 0)
+    {
+      if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (difference < 0)
+    {
+      site.suppressed.fetch_add(1, std::memory_order_relaxed);
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    else
+      position = enqueue_position_.load(std::memory_order_relaxed);
+  }
+
+  va_list args;
+  va_start(args, format);
+  vsnprintf(record->text, MAX_MESSAGE_LENGTH, format, args);
+  va_end(args);
+  record->site = &site;
+  record->suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+  record->sequence.store(position + 1, std::memory_order_release);
+}
+
+void* AsyncLog::drainThread(void* arg)
+{
+  // Only run when nothing else wants the CPU
+  sched_param param;
+  param.sched_priority = 0;
+  pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+  AsyncLog* log = static_cast<AsyncLog*>(arg);
+  const timespec period = { 0, DRAIN_PERIOD_NS };
+  while (!log->stop_.load(std::memory_order_acquire))
+  {
+    if (!log->drain())
+      nanosleep(&period, nullptr);
+  }
+  log->drain();
+
+  return nullptr;
+}
+
+bool AsyncLog::drain()
+{
+  bool drained = false;
+  while (true)
+  {
+    Record& record = records_[dequeue_position_ & (QUEUE_CAPACITY - 1)];
+    if (record.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1)
+      break;
+
+    write(*record.site, record.text, record.suppressed);
+    record.sequence.store(dequeue_position_ + QUEUE_CAPACITY, std::memory_order_release);
+    ++dequeue_position_;
+    drained = true;
+  }
+
+  const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+  if (dropped != reported_dropped_)
+  {
+    ROS_WARN("%llu jog_arm log messages were dropped. The queue was full.",
+             static_cast<unsigned long long>(dropped - reported_dropped_));
+    reported_dropped_ = dropped;
+  }
+
+  return drained;
+}
+
+// What the ROS_LOG macros do, with the call site's location
+void AsyncLog::write(AsyncLogSite& site, const char* text, const uint32_t suppressed)
+{
+  ROSCONSOLE_AUTOINIT;
+  ros::console::LogLocation& location = site.location;
+  if (!location.initialized_)
+    ros::console::initializeLogLocation(&location, std::string(ROSCONSOLE_NAME_PREFIX) + "." + site.name, site.level);
+  if (location.level_ != site.level)
+  {
+    ros::console::setLogLocationLevel(&location, site.level);
+    ros::console::checkLogLocationEnabled(&location);
+  }
+  if (!location.logger_enabled_)
+    return;
+
+  if (suppressed)
+    ros::console::print(nullptr, location.logger_, location.level_, site.file, site.line, site.function,
+                        "%s (%u similar messages suppressed)", text, suppressed);
+  else
+    ros::console::print(nullptr, location.logger_, location.level_, site.file, site.line, site.function, "%s", text);
+}
+}  // namespace jog_arm
@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : cycle_arena.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Per-cycle bump allocator for outgoing messages.
+
+#include <jog_arm/cycle_arena.h>
+#include <algorithm>
+
+namespace jog_arm
+{
+CycleArena::CycleArena(const std::size_t initial_capacity)
+{
+  addBlock(std::max(initial_capacity, static_cast<std::size_t>(alignof(std::max_align_t))));
+}
+
+void* CycleArena::allocate(const std::size_t bytes, const std::size_t alignment)
+{
+  // Blocks come from new[], so they are aligned for any fundamental type
+  std::size_t start = (offset_ + alignment - 1) / alignment * alignment;
+  if (start + bytes > blocks_.back().size)
+  {
+    addBlock(std::max(2 * blocks_.back().size, bytes + alignment));
+    start = 0;
+  }
+
+  offset_ = start + bytes;
+  return blocks_.back().data.get() + start;
+}
+
+void CycleArena::reset()
+{
+  // Merge the overflow, so the next cycle fits in one block
+  if (blocks_.size() > 1)
+  {
+    const std::size_t total = capacity();
+    blocks_.clear();
+    addBlock(total);
+  }
+  offset_ = 0;
+}
+
+std::size_t CycleArena::capacity() const
+{
+  std::size_t total = 0;
+  for (const Block& block : blocks_)
+    total += block.size;
+  return total;
+}
+
+void CycleArena::addBlock(const std::size_t size)
+{
+  blocks_.push_back(Block{ std::unique_ptr<char[]>(new char[size]), size });
+  offset_ = 0;
+}
+}  // namespace jog_arm
@@ -0,0 +1,349 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : evdev_joystick.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Reads a joystick straight from its Linux evdev device, without joy_node.
+
+#include <jog_arm/evdev_joystick.h>
+#include <ros/ros.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace jog_arm
+{
+static const std::string NODE_NAME = "evdev_joystick";
+// How often to try opening a missing device [s]
+static const double REOPEN_PERIOD = 1.;
+static const std::size_t EVENT_BUFFER_SIZE = 64;
+
+static bool testBit(const std::vector<uint8_t>& bits, const std::size_t bit)
+{
+  return bits[bit / 8] & (1 << (bit % 8));
+}
+
+EvdevJoystick::EvdevJoystick(const std::string& device, const double repeat_period, Callback callback)
+  : device_(device), repeat_period_(repeat_period), callback_(callback)
+{
+}
+
+EvdevJoystick::~EvdevJoystick()
+{
+  stop();
+}
+
+bool EvdevJoystick::start()
+{
+  if (thread_started_)
+    return true;
+
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  stop_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (epoll_fd_ < 0 || stop_fd_ < 0)
+  {
+    ROS_ERROR_STREAM_NAMED(NODE_NAME, "Creating the epoll instance failed: " << strerror(errno));
+    stop();
+    return false;
+  }
+
+  epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = stop_fd_;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &event) ||
+      pthread_create(&thread_, nullptr, &EvdevJoystick::readerThread, this))
+  {
+    ROS_ERROR_STREAM_NAMED(NODE_NAME, "Starting the reader thread for '" << device_ << "' failed");
+    stop();
+    return false;
+  }
+  thread_started_ = true;
+  return true;
+}
+
+void EvdevJoystick::stop()
+{
+  if (thread_started_)
+  {
+    const uint64_t one = 1;
+    (void)write(stop_fd_, &one, sizeof(one));
+    (void)pthread_join(thread_, nullptr);
+    thread_started_ = false;
+  }
+
+  closeDevice();
+  if (stop_fd_ >= 0)
+    close(stop_fd_);
+  stop_fd_ = -1;
+  if (epoll_fd_ >= 0)
+    close(epoll_fd_);
+  epoll_fd_ = -1;
+}
+
+void* EvdevJoystick::readerThread(void* joystick)
+{
+  static_cast<EvdevJoystick*>(joystick)->read();
+  return nullptr;
+}
+
+void EvdevJoystick::read()
+{
+  bool reported_missing = false;
+  while (true)
+  {
+    int timeout = -1;
+    if (device_fd_ < 0)
+    {
+      if (openDevice())
+      {
+        ROS_INFO_STREAM_NAMED(NODE_NAME, "Reading joystick '" << device_ << "'");
+        reported_missing = false;
+      }
+      else
+      {
+        if (!reported_missing)
+          ROS_WARN_STREAM_NAMED(NODE_NAME, "Can't open joystick '" << device_ << "': " << strerror(errno)
+                                                                   << ". Retrying.");
+        reported_missing = true;
+        timeout = static_cast<int>(REOPEN_PERIOD * 1000);
+      }
+    }
+    if (device_fd_ >= 0 && active_)
+      timeout = static_cast<int>(std::ceil(repeat_period_ * 1000));
+
+    epoll_event events[2];
+    const int num_events = epoll_wait(epoll_fd_, events, 2, timeout);
+    if (num_events < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      ROS_ERROR_STREAM_NAMED(NODE_NAME, "Waiting for joystick '" << device_ << "' failed: " << strerror(errno));
+      return;
+    }
+
+    // Nothing new. Repeat a held input.
+    if (num_events == 0 && device_fd_ >= 0 && active_)
+      active_ = callback_(axes_, buttons_);
+
+    for (int i = 0; i < num_events; ++i)
+    {
+      if (events[i].data.fd == stop_fd_)
+        return;
+
+      if (events[i].data.fd == device_fd_ && !readEvents())
+      {
+        ROS_WARN_STREAM_NAMED(NODE_NAME, "Lost joystick '" << device_ << "'");
+        closeDevice();
+
+        // Don't keep jogging with the last input
+        std::fill(axes_.begin(), axes_.end(), 0.f);
+        std::fill(buttons_.begin(), buttons_.end(), 0);
+        if (active_)
+          active_ = callback_(axes_, buttons_);
+      }
+    }
+  }
+}
+
+bool EvdevJoystick::openDevice()
+{
+  device_fd_ = open(device_.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (device_fd_ < 0)
+    return false;
+
+  std::vector<uint8_t> abs_bits(ABS_CNT / 8 + 1, 0);
+  std::vector<uint8_t> key_bits(KEY_CNT / 8 + 1, 0);
+  if (ioctl(device_fd_, EVIOCGBIT(EV_ABS, abs_bits.size()), abs_bits.data()) < 0 ||
+      ioctl(device_fd_, EVIOCGBIT(EV_KEY, key_bits.size()), key_bits.data()) < 0)
+  {
+    const int error = errno;
+    closeDevice();
+    errno = error;
+    return false;
+  }
+  numberInputs(abs_bits, key_bits);
+
+  axis_info_.resize(axis_codes_.size());
+  for (std::size_t axis = 0; axis < axis_codes_.size(); ++axis)
+    (void)ioctl(device_fd_, EVIOCGABS(axis_codes_[axis]), &axis_info_[axis]);
+
+  epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = device_fd_;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, device_fd_, &event))
+  {
+    const int error = errno;
+    closeDevice();
+    errno = error;
+    return false;
+  }
+
+  synchronize();
+  dropped_ = false;
+  active_ = callback_(axes_, buttons_);
+  return true;
+}
+
+void EvdevJoystick::closeDevice()
+{
+  if (device_fd_ < 0)
+    return;
+  // Closing the descriptor also removes it from the epoll set
+  close(device_fd_);
+  device_fd_ = -1;
+}
+
+void EvdevJoystick::numberInputs(const std::vector<uint8_t>& abs_bits, const std::vector<uint8_t>& key_bits)
+{
+  axis_indices_.assign(ABS_CNT, -1);
+  axis_codes_.clear();
+  for (int code = 0; code < ABS_CNT; ++code)
+  {
+    if (!testBit(abs_bits, code))
+      continue;
+    axis_indices_[code] = static_cast<int>(axis_codes_.size());
+    axis_codes_.push_back(code);
+  }
+
+  // Joystick buttons first, then the miscellaneous buttons below them. Keyboard keys are ignored.
+  button_indices_.assign(KEY_CNT, -1);
+  int num_buttons = 0;
+  for (int code = BTN_JOYSTICK; code < KEY_CNT; ++code)
+  {
+    if (testBit(key_bits, code))
+      button_indices_[code] = num_buttons++;
+  }
+  for (int code = BTN_MISC; code < BTN_JOYSTICK; ++code)
+  {
+    if (testBit(key_bits, code))
+      button_indices_[code] = num_buttons++;
+  }
+
+  axes_.assign(axis_codes_.size(), 0.f);
+  buttons_.assign(num_buttons, 0);
+}
+
+void EvdevJoystick::synchronize()
+{
+  for (std::size_t axis = 0; axis < axis_codes_.size(); ++axis)
+  {
+    if (ioctl(device_fd_, EVIOCGABS(axis_codes_[axis]), &axis_info_[axis]) >= 0)
+      axes_[axis] = scaleAxis(axis, axis_info_[axis].value);
+  }
+
+  std::vector<uint8_t> key_state(KEY_CNT / 8 + 1, 0);
+  if (ioctl(device_fd_, EVIOCGKEY(key_state.size()), key_state.data()) >= 0)
+  {
+    for (int code = BTN_MISC; code < KEY_CNT; ++code)
+    {
+      if (button_indices_[code] >= 0)
+        buttons_[button_indices_[code]] = testBit(key_state, code);
+    }
+  }
+}
+
+bool EvdevJoystick::readEvents()
+{
+  // Several reports may be pending. Pass on only the latest state.
+  bool changed = false;
+  input_event events[EVENT_BUFFER_SIZE];
+  while (true)
+  {
+    const ssize_t bytes = ::read(device_fd_, events, sizeof(events));
+    if (bytes < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        return false;
+      break;
+    }
+    if (bytes == 0)
+      return false;
+
+    const std::size_t num_events = bytes / sizeof(input_event);
+    for (std::size_t i = 0; i < num_events; ++i)
+    {
+      const input_event& event = events[i];
+      if (event.type == EV_SYN && event.code == SYN_DROPPED)
+      {
+        dropped_ = true;
+      }
+      else if (event.type == EV_SYN && event.code == SYN_REPORT)
+      {
+        if (dropped_)
+          synchronize();
+        dropped_ = false;
+        changed = true;
+      }
+      else if (dropped_)
+      {
+        continue;
+      }
+      else if (event.type == EV_ABS && event.code < ABS_CNT && axis_indices_[event.code] >= 0)
+      {
+        axes_[axis_indices_[event.code]] = scaleAxis(axis_indices_[event.code], event.value);
+      }
+      else if (event.type == EV_KEY && event.code < KEY_CNT && button_indices_[event.code] >= 0)
+      {
+        buttons_[button_indices_[event.code]] = event.value != 0;
+      }
+    }
+  }
+
+  if (changed)
+    active_ = callback_(axes_, buttons_);
+  return true;
+}
+
+float EvdevJoystick::scaleAxis(const std::size_t axis, const int value) const
+{
+  const double half_range = 0.5 * (static_cast<double>(axis_info_[axis].maximum) - axis_info_[axis].minimum);
+  if (half_range <= 0)
+    return 0.f;
+  const double center = 0.5 * (static_cast<double>(axis_info_[axis].maximum) + axis_info_[axis].minimum);
+
+  // joy_node flips the sign, so pushing a stick up or to the left reads positive
+  const double scaled = std::max(-1., std::min(1., (value - center) / half_range));
+  return static_cast<float>(-scaled);
+}
+}  // namespace jog_arm
@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : jerk_limited_smoother.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Online jerk-limited smoothing of outgoing joint commands.
+
+#include <jog_arm/jerk_limited_smoother.h>
+#include <cmath>
+
+namespace jog_arm
+{
+// Velocities and accelerations below this count as stopped
+static const double AT_REST_TOLERANCE = 1e-6;
+
+JerkLimitedSmoother::JerkLimitedSmoother(const Eigen::VectorXd& max_velocity, const Eigen::VectorXd& max_acceleration,
+                                         const Eigen::VectorXd& max_jerk, const double sample_period)
+  : max_velocity_(max_velocity)
+  , max_acceleration_(max_acceleration)
+  , max_jerk_(max_jerk)
+  , sample_period_(sample_period)
+  , position_(Eigen::VectorXd::Zero(max_velocity.size()))
+  , velocity_(Eigen::VectorXd::Zero(max_velocity.size()))
+  , acceleration_(Eigen::VectorXd::Zero(max_velocity.size()))
+{
+}
+
+void JerkLimitedSmoother::reset(const double* position)
+{
+  position_ = Eigen::Map<const Eigen::VectorXd>(position, position_.size());
+  velocity_.setZero();
+  acceleration_.setZero();
+}
+
+void JerkLimitedSmoother::setLimits(const Eigen::VectorXd& max_acceleration, const Eigen::VectorXd& max_jerk)
+{
+  max_acceleration_ = max_acceleration;
+  max_jerk_ = max_jerk;
+}
+
+bool JerkLimitedSmoother::isAtRest() const
+{
+  return velocity_.cwiseAbs().maxCoeff() < AT_REST_TOLERANCE &&
+         acceleration_.cwiseAbs().maxCoeff() < AT_REST_TOLERANCE;
+}
+
+void JerkLimitedSmoother::update(const Eigen::VectorXd& target_velocity)
+{
+  const double dt = sample_period_;
+
+  for (long i = 0; i < velocity_.size(); ++i)
+  {
+    const double v_max = max_velocity_[i];
+    const double a_max = max_acceleration_[i];
+    const double j_step = max_jerk_[i] * dt;  // Largest acceleration change in one cycle
+
+    const double target = std::min(std::max(target_velocity[i], -v_max), v_max);
+    const double error = target - velocity_[i];
+    const double a = acceleration_[i];
+
+    double new_acceleration;
+
+    // Close enough to land on the target this cycle and still bring the acceleration to zero next cycle
+    const double landing_acceleration = error / dt;
+    if (std::fabs(landing_acceleration) <= std::min(a_max, j_step) && std::fabs(landing_acceleration - a) <= j_step)
+    {
+      new_acceleration = landing_acceleration;
+    }
+    else
+    {
+      // Work in the direction of the error, so it is positive.
+      // The velocity gained by applying acceleration x this cycle, then ramping it down by j_step per cycle,
+      // is dt*(x + (x - j_step) + ... ) over the positive terms. With m whole steps of j_step below x, that is
+      // dt*((m+1)*x - j_step*m*(m+1)/2). Find the largest x that does not overshoot the target.
+      const double direction = (error < 0.) ? -1. : 1.;
+      const double remaining = direction * error / dt;
+      // The continuous ramp, dt*(x/2 + x^2/(2*j_step)), gains no more than this, so it gives an upper bound on m
+      const double steps = std::floor(-0.5 + std::sqrt(0.25 + 2. * remaining / j_step));
+      const double ideal_acceleration = (remaining + 0.5 * j_step * steps * (steps + 1.)) / (steps + 1.);
+
+      // Jerk and acceleration limits
+      const double current = direction * a;
+      new_acceleration = std::min(std::max(ideal_acceleration, current - j_step), current + j_step);
+      new_acceleration = direction * std::min(std::max(new_acceleration, -a_max), a_max);
+    }
+
+    double new_velocity = velocity_[i] + new_acceleration * dt;
+    if (std::fabs(new_velocity) > v_max)
+    {
+      new_velocity = std::copysign(v_max, new_velocity);
+      new_acceleration = (new_velocity - velocity_[i]) / dt;
+    }
+
+    // Trapezoidal integration of position
+    position_[i] += 0.5 * (velocity_[i] + new_velocity) * dt;
+    velocity_[i] = new_velocity;
+    acceleration_[i] = new_acceleration;
+  }
+}
+}  // namespace jog_arm
@@ -40,440 +40,1679 @@
 // Server node for arm jogging with MoveIt.
 
 #include <jog_arm/jog_arm_server.h>
+#include <boost/make_shared.hpp>
+#include <algorithm>
+#include <limits>
 #include <memory>
-
-// Initialize these static struct to hold ROS parameters.
-// They must be static because they are used as arguments in thread creation.
-jog_arm::jog_arm_parameters jog_arm::JogROSInterface::ros_parameters_;
-jog_arm::jog_arm_shared jog_arm::JogROSInterface::shared_variables_;
-std::unique_ptr<robot_model_loader::RobotModelLoader> jog_arm::JogROSInterface::model_loader_ptr_ = NULL;
+#include <set>
 
 /////////////////////////////////////////////////////////////////////////////////
-// JogROSInterface handles ROS subscriptions and instantiates the worker
-// threads.
-// One worker thread does the jogging calculations.
-// Another worker thread does collision checking.
+// JogROSInterface handles ROS subscriptions and schedules periodic tasks on a
+// PeriodicTaskExecutor, which may be shared with the host.
+// One task per move group, or per pair of move groups jogged together, does
+// the jogging calculations every publish_period. It pauses while idle.
+// A lower-priority task does collision checking for all of them, and another
+// reports the executor's overruns.
+// The main thread spins the callbacks and publishes the latest commands in run(),
+// unless the host calls publishCommands() itself.
 /////////////////////////////////////////////////////////////////////////////////
 
 static const char* const NODE_NAME = "jog_arm_server";
 static const int GAZEBO_REDUNTANT_MESSAGE_COUNT = 30;
+// Stop publishing after this many cycles of zero velocity, so other controllers can take over
+static const int NUM_ZERO_CYCLES_TO_PUBLISH = 4;
+// How often to report executor overruns [s]
+static const double TELEMETRY_PERIOD = 5;
+
+// While idle, wake this often [s] to check whether ROS is shutting down
+static const double IDLE_SPIN_TIMEOUT = 0.5;
+// Repeat a held joystick input this often [s], or faster if incoming_command_timeout is shorter
+static const double DIRECT_INPUT_REPEAT_PERIOD = 0.1;
+// Re-read the TF transform of a command frame off the move group this often [s]
+static const double REFERENCE_FRAME_CACHE_PERIOD = 0.1;
+// Joint step for the manipulability gradient [rad or m]
+static const double MANIPULABILITY_GRADIENT_STEP = 1e-4;
+// Executor priorities. Higher runs first.
+static const int JOG_CALCS_PRIORITY = 2;
+static const int COLLISION_CHECK_PRIORITY = 1;
+static const int TELEMETRY_PRIORITY = 0;
 
-// MAIN
-int main(int argc, char** argv)
+namespace jog_arm
 {
-  ros::init(argc, argv, NODE_NAME);
+FilterSpec getJointFilterSpec(const jog_arm_parameters& parameters)
+{
+  FilterSpec spec;
+  parseFilterType(parameters.low_pass_filter_type, spec.type);
+  spec.order = parameters.low_pass_filter_order;
+  spec.cutoff_frequency = parameters.low_pass_filter_cutoff_frequency;
+  spec.sample_period = parameters.publish_period;
+  spec.one_euro_beta = parameters.one_euro_beta;
+  spec.one_euro_derivative_cutoff = parameters.one_euro_derivative_cutoff;
+  return spec;
+}
 
-  jog_arm::JogROSInterface ros_interface;
+// Collision checking runs at the fastest collision_check_rate of the move groups that enable it
+static double getCollisionCheckPeriod(const std::vector<const jog_arm_parameters*>& parameters)
+{
+  double collision_check_rate = 0;
+  for (const jog_arm_parameters* group_parameters : parameters)
+  {
+    if (group_parameters->collision_check)
+      collision_check_rate = std::max(collision_check_rate, group_parameters->collision_check_rate);
+  }
+  return 1. / collision_check_rate;
+}
 
-  return 0;
+// A very low cutoff frequency
+static FilterSpec getVelocityScaleFilterSpec(double sample_period)
+{
+  FilterSpec velocity_scale_filter_spec;
+  velocity_scale_filter_spec.sample_period = sample_period;
+  velocity_scale_filter_spec.cutoff_frequency =
+      LowPassFilterBank::cutoffFromCoefficient(20, velocity_scale_filter_spec.sample_period);
+  return velocity_scale_filter_spec;
 }
 
-namespace jog_arm
+static bool isZeroTwist(const geometry_msgs::Twist& twist)
+{
+  return twist.linear.x == 0.0 && twist.linear.y == 0.0 && twist.linear.z == 0.0 && twist.angular.x == 0.0 &&
+         twist.angular.y == 0.0 && twist.angular.z == 0.0;
+}
+
+// Position and rotation vector from actual to target, in the frame both are given in
+static Eigen::VectorXd getPoseError(const Eigen::Isometry3d& target, const Eigen::Isometry3d& actual)
+{
+  Eigen::VectorXd error(6);
+  error.head<3>() = target.translation() - actual.translation();
+  const Eigen::AngleAxisd rotation_error(target.rotation() * actual.rotation().transpose());
+  error.tail<3>() = rotation_error.angle() * rotation_error.axis();
+  return error;
+}
+
+// Move a pose by a displacement in the frame it is given in: a translation and a rotation vector
+static void displacePose(Eigen::Isometry3d& pose, const Eigen::VectorXd& delta)
+{
+  pose.translation() += delta.head<3>();
+  const Eigen::Vector3d rotation = delta.tail<3>();
+  if (rotation.norm() > 0.)
+    pose.linear() = Eigen::AngleAxisd(rotation.norm(), rotation.normalized()).toRotationMatrix() * pose.rotation();
+}
+
+// The component of vector along direction. Zero if direction is zero.
+static Eigen::Vector3d projectOnto(const Eigen::Vector3d& vector, const Eigen::Vector3d& direction)
 {
+  const double squared_norm = direction.squaredNorm();
+  if (squared_norm == 0.)
+    return Eigen::Vector3d::Zero();
+  return direction * (vector.dot(direction) / squared_norm);
+}
+
+static bool isStopRequested(jog_arm_shared& shared_variables)
+{
+  pthread_mutex_lock(&shared_variables.stop_requested_mutex);
+  bool stop_requested = shared_variables.stop_requested;
+  pthread_mutex_unlock(&shared_variables.stop_requested_mutex);
+  return stop_requested;
+}
+
+static bool isStopRequested(std::deque<jog_arm_shared>& shared_variables)
+{
+  for (jog_arm_shared& group_shared_variables : shared_variables)
+  {
+    if (isStopRequested(group_shared_variables))
+      return true;
+  }
+  return false;
+}
+
 // Constructor for the main ROS interface node
-JogROSInterface::JogROSInterface()
+JogROSInterface::JogROSInterface(const ros::NodeHandle& n, const std::vector<std::string>& parameter_namespaces,
+                                 const std::shared_ptr<robot_model_loader::RobotModelLoader>& model_loader_ptr,
+                                 const std::shared_ptr<PeriodicTaskExecutor>& executor)
+  : nh_(n), parameter_namespaces_(parameter_namespaces), model_loader_ptr_(model_loader_ptr), executor_(executor)
 {
-  ros::NodeHandle n;
+  pthread_mutex_init(&idle_mutex_, nullptr);
+}
+
+JogROSInterface::~JogROSInterface()
+{
+  stop();
+  pthread_mutex_destroy(&idle_mutex_);
+}
+
+// Read parameters, then schedule the calculations and start the ROS subs & pubs
+bool JogROSInterface::start()
+{
+  if (started_)
+    return true;
+
+  const ros::WallTime start_time = ros::WallTime::now();
+
+  // Start the log drain thread now rather than on the first warning from a jog cycle
+  AsyncLog::instance();
+
+  if (parameter_namespaces_.empty())
+  {
+    ROS_ERROR_STREAM_NAMED(NODE_NAME, "At least one parameter namespace is needed");
+    return false;
+  }
 
   // Read ROS parameters, typically from YAML file
-  if (!readParameters(n))
-    exit(EXIT_FAILURE);
+  ros_parameters_.resize(parameter_namespaces_.size());
+  for (std::size_t group = 0; group < parameter_namespaces_.size(); ++group)
+  {
+    if (!readParameters(nh_, parameter_namespaces_[group], ros_parameters_[group]))
+      return false;
 
-  // Load the robot model. This is needed by the worker threads.
-  model_loader_ptr_ = std::unique_ptr<robot_model_loader::RobotModelLoader>(new robot_model_loader::RobotModelLoader);
+    for (std::size_t other = 0; other < group; ++other)
+    {
+      if (ros_parameters_[other].move_group_name == ros_parameters_[group].move_group_name)
+      {
+        ROS_ERROR_STREAM_NAMED(NODE_NAME, "Namespaces '" << parameter_namespaces_[other] << "' and '"
+                                                         << parameter_namespaces_[group]
+                                                         << "' jog the same move group. Check yaml file.");
+        return false;
+      }
+    }
+  }
 
-  // Crunch the numbers in this thread
-  pthread_t joggingThread;
-  int rc = pthread_create(&joggingThread, nullptr, jog_arm::JogROSInterface::jogCalcThread, this);
-  if (rc)
+  // Pair up the move groups that are jogged together
+  partner_groups_.assign(ros_parameters_.size(), -1);
+  coordinated_pairs_.clear();
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
   {
-    ROS_FATAL_STREAM_NAMED(NODE_NAME, "Creating jog calculation thread failed");
-    return;
+    if (!ros_parameters_[group].coordinated_jogging)
+      continue;
+
+    std::size_t partner = 0;
+    while (partner < ros_parameters_.size() &&
+           ros_parameters_[partner].move_group_name != ros_parameters_[group].coordinated_partner_move_group_name)
+      ++partner;
+    if (partner == ros_parameters_.size())
+    {
+      ROS_ERROR_STREAM_NAMED(NODE_NAME, "Move group '" << ros_parameters_[group].coordinated_partner_move_group_name
+                                                       << "' should be jogged together with '"
+                                                       << ros_parameters_[group].move_group_name
+                                                       << "', but none of the parameter namespaces jogs it.");
+      return false;
+    }
+    // Both move groups may name each other
+    if (partner_groups_[group] == static_cast<int>(partner))
+      continue;
+    if (partner_groups_[group] >= 0 || partner_groups_[partner] >= 0)
+    {
+      ROS_ERROR_STREAM_NAMED(NODE_NAME, "A move group can only be jogged together with one partner. Check yaml file.");
+      return false;
+    }
+    if (ros_parameters_[group].publish_period != ros_parameters_[partner].publish_period ||
+        ros_parameters_[group].planning_frame != ros_parameters_[partner].planning_frame)
+    {
+      ROS_ERROR_STREAM_NAMED(NODE_NAME, "Move groups that are jogged together need the same 'publish_period' and "
+                                        "'planning_frame'. Check yaml file.");
+      return false;
+    }
+
+    partner_groups_[group] = static_cast<int>(partner);
+    partner_groups_[partner] = static_cast<int>(group);
+    coordinated_pairs_.push_back(std::make_pair(group, partner));
   }
 
-  // Check collisions in this thread
-  pthread_t collisionThread;
-  rc = pthread_create(&collisionThread, nullptr, jog_arm::JogROSInterface::CollisionCheckThread, this);
-  if (rc)
+  shared_variables_.resize(ros_parameters_.size());
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
   {
-    ROS_FATAL_STREAM_NAMED(NODE_NAME, "Creating collision check thread failed");
-    return;
+    shared_variables_[group].start_time = start_time;
+    shareParameters(group);
+
+    // Set the input frame, as determined by YAML file:
+    pthread_mutex_lock(&shared_variables_[group].command_deltas_mutex);
+    shared_variables_[group].command_deltas.header.frame_id = ros_parameters_[group].command_frame;
+    pthread_mutex_unlock(&shared_variables_[group].command_deltas_mutex);
+  }
+  coordinated_shared_variables_.resize(coordinated_pairs_.size());
+  for (std::size_t pair = 0; pair < coordinated_pairs_.size(); ++pair)
+  {
+    const std::string& command_frame = ros_parameters_[coordinated_pairs_[pair].first].command_frame;
+    pthread_mutex_lock(&coordinated_shared_variables_[pair].command_mutex);
+    coordinated_shared_variables_[pair].object_command.header.frame_id = command_frame;
+    coordinated_shared_variables_[pair].relative_command.header.frame_id = command_frame;
+    pthread_mutex_unlock(&coordinated_shared_variables_[pair].command_mutex);
   }
 
-  // ROS subscriptions. Share the data with the worker threads
-  ros::Subscriber cmd_sub =
-      n.subscribe(ros_parameters_.cartesian_command_in_topic, 1, &JogROSInterface::deltaCartesianCmdCB, this);
-  ros::Subscriber joints_sub = n.subscribe(ros_parameters_.joint_topic, 1, &JogROSInterface::jointsCB, this);
-  ros::Subscriber joint_jog_cmd_sub =
-      n.subscribe(ros_parameters_.joint_command_in_topic, 1, &JogROSInterface::deltaJointCmdCB, this);
-  ros::topic::waitForMessage<sensor_msgs::JointState>(ros_parameters_.joint_topic);
-  ros::topic::waitForMessage<geometry_msgs::TwistStamped>(ros_parameters_.cartesian_command_in_topic);
+  // Load the robot model, unless the caller shares one. This is needed by the worker threads.
+  if (!model_loader_ptr_)
+  {
+    // Kinematics solver plugins are slow to load, so only load them for IK re-anchoring
+    bool load_kinematics_solvers = false;
+    for (const jog_arm_parameters& parameters : ros_parameters_)
+      load_kinematics_solvers |= parameters.correct_drift && parameters.drift_correction_ik_period > 0.;
+    model_loader_ptr_ = loadRobotModel(nh_, "robot_description", load_kinematics_solvers);
+    if (!model_loader_ptr_)
+      return false;
+    ROS_INFO_STREAM_NAMED(NODE_NAME, "Loaded the robot model in " << (ros::WallTime::now() - start_time).toSec()
+                                                                  << " s");
+  }
+  for (const jog_arm_parameters& parameters : ros_parameters_)
+  {
+    if (!model_loader_ptr_->getModel()->hasJointModelGroup(parameters.move_group_name))
+    {
+      ROS_ERROR_STREAM_NAMED(NODE_NAME, "The robot model has no move group '" << parameters.move_group_name
+                                                                              << "'. Check yaml file.");
+      return false;
+    }
+  }
+  transform_listener_ = std::unique_ptr<tf::TransformListener>(new tf::TransformListener(nh_));
+
+  // ROS subscriptions. Share the data with the worker threads.
+  // Move groups that read the same joint topic share one subscription.
+  std::set<std::string> joint_topics;
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
+  {
+    subscribers_.push_back(nh_.subscribe<geometry_msgs::TwistStamped>(
+        ros_parameters_[group].cartesian_command_in_topic, 1,
+        boost::bind(&JogROSInterface::deltaCartesianCmdCB, this, _1, group)));
+    subscribers_.push_back(nh_.subscribe<jog_msgs::JogJoint>(
+        ros_parameters_[group].joint_command_in_topic, 1,
+        boost::bind(&JogROSInterface::deltaJointCmdCB, this, _1, group)));
+    subscribers_.push_back(nh_.subscribe<geometry_msgs::PoseStamped>(
+        ros_parameters_[group].pose_command_in_topic, 1, boost::bind(&JogROSInterface::poseCmdCB, this, _1, group)));
+    joint_topics.insert(ros_parameters_[group].joint_topic);
+  }
+  // JogFrame msgs name their move group, so move groups that share a topic share one subscription
+  std::set<std::string> frame_topics;
+  for (const jog_arm_parameters& parameters : ros_parameters_)
+    frame_topics.insert(parameters.frame_command_in_topic);
+  for (const std::string& topic : frame_topics)
+  {
+    subscribers_.push_back(nh_.subscribe<jog_msgs::JogFrame>(
+        topic, 1, boost::bind(&JogROSInterface::deltaFrameCmdCB, this, _1, topic)));
+  }
+  for (std::size_t pair = 0; pair < coordinated_pairs_.size(); ++pair)
+  {
+    const jog_arm_parameters& parameters = ros_parameters_[coordinated_pairs_[pair].first];
+    subscribers_.push_back(nh_.subscribe<geometry_msgs::TwistStamped>(
+        parameters.object_command_in_topic, 1,
+        boost::bind(&JogROSInterface::coordinatedCmdCB, this, _1, pair, false)));
+    subscribers_.push_back(nh_.subscribe<geometry_msgs::TwistStamped>(
+        parameters.relative_command_in_topic, 1,
+        boost::bind(&JogROSInterface::coordinatedCmdCB, this, _1, pair, true)));
+  }
+  // Joint states are parsed straight into frames of the joints the move groups need
+  joint_frame_indices_.resize(ros_parameters_.size());
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
+  {
+    std::unique_ptr<JointStateParser>& parser = joint_state_parsers_[ros_parameters_[group].joint_topic];
+    if (!parser)
+      parser.reset(new JointStateParser());
+    const std::vector<std::string>& names =
+        model_loader_ptr_->getModel()->getJointModelGroup(ros_parameters_[group].move_group_name)->getVariableNames();
+    if (!parser->addJoints(names, joint_frame_indices_[group]))
+    {
+      ROS_ERROR_STREAM_NAMED(NODE_NAME, "The move groups on joint topic '" << ros_parameters_[group].joint_topic
+                                                                            << "' have more than " << MAX_FRAME_JOINTS
+                                                                            << " joints.");
+      return false;
+    }
+  }
+  for (const std::string& topic : joint_topics)
+  {
+    JointStateParser* parser = joint_state_parsers_[topic].get();
+    ros::SubscribeOptions options;
+    options.initByFullCallbackType<const boost::shared_ptr<const ParsedJointState>&>(
+        topic, 1, boost::bind(&JogROSInterface::jointsCB, this, _1, topic),
+        [parser] { return boost::make_shared<ParsedJointState>(parser); });
+    subscribers_.push_back(nh_.subscribe(options));
+  }
+
+  // The jogging calculations for each move group, and collision checking for all of them
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
+    jog_calcs_.emplace_back(
+        new JogCalcs(ros_parameters_[group], shared_variables_[group], model_loader_ptr_, *transform_listener_));
+  for (std::size_t pair = 0; pair < coordinated_pairs_.size(); ++pair)
+    coordinated_jog_calcs_.emplace_back(new CoordinatedJogCalcs(*jog_calcs_[coordinated_pairs_[pair].first],
+                                                                *jog_calcs_[coordinated_pairs_[pair].second],
+                                                                coordinated_shared_variables_[pair]));
+  collision_check_.reset(
+      new CollisionCheck(ros_parameters_, shared_variables_, coordinated_pairs_, model_loader_ptr_));
 
   // Publish freshly-calculated joints to the robot
   // Put the outgoing msg in the right format (trajectory_msgs/JointTrajectory
   // or std_msgs/Float64MultiArray).
-  ros::Publisher outgoing_cmd_pub;
-  if (ros_parameters_.command_out_type == "trajectory_msgs/JointTrajectory")
-    outgoing_cmd_pub = n.advertise<trajectory_msgs::JointTrajectory>(ros_parameters_.command_out_topic, 1);
-  else if (ros_parameters_.command_out_type == "std_msgs/Float64MultiArray")
-    outgoing_cmd_pub = n.advertise<std_msgs::Float64MultiArray>(ros_parameters_.command_out_topic, 1);
+  outgoing_cmd_pubs_.resize(ros_parameters_.size());
+  outgoing_trajs_.resize(ros_parameters_.size());
+  serialized_trajs_.resize(ros_parameters_.size());
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
+  {
+    if (ros_parameters_[group].command_out_type == "trajectory_msgs/JointTrajectory")
+      outgoing_cmd_pubs_[group] =
+          nh_.advertise<trajectory_msgs::JointTrajectory>(ros_parameters_[group].command_out_topic, 1);
+    else if (ros_parameters_[group].command_out_type == "std_msgs/Float64MultiArray")
+      outgoing_cmd_pubs_[group] =
+          nh_.advertise<std_msgs::Float64MultiArray>(ros_parameters_[group].command_out_topic, 1);
+  }
+
+  // Publish at the fastest publish_period. Slower move groups publish every few cycles.
+  min_publish_period_ = std::numeric_limits<double>::max();
+  for (const jog_arm_parameters& parameters : ros_parameters_)
+    min_publish_period_ = std::min(min_publish_period_, parameters.publish_period);
+  publish_divisors_.resize(ros_parameters_.size());
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
+    publish_divisors_[group] = std::max(
+        1u, static_cast<unsigned int>(std::round(ros_parameters_[group].publish_period / min_publish_period_)));
+
+  // Schedule the calculations on the executor, which may be shared with other servers.
+  // Jogging calculations are the most urgent, then collision checking, then telemetry.
+  // A jogging task pauses itself when it has nothing to do.
+  if (!executor_)
+    executor_ = std::make_shared<PeriodicTaskExecutor>();
+  // A shared executor may already run the tasks, so hold the idle mutex until their IDs are stored
+  pthread_mutex_lock(&idle_mutex_);
+  idle_groups_.assign(ros_parameters_.size(), false);
+  jog_task_ids_.assign(ros_parameters_.size(), 0);
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
+  {
+    // Move groups that are jogged together are solved in one task
+    if (partner_groups_[group] >= 0)
+      continue;
+
+    JogCalcs* jog_calcs = jog_calcs_[group].get();
+    const std::vector<std::size_t> groups(1, group);
+    task_ids_.push_back(executor_->addTask(ros_parameters_[group].move_group_name + " jog calculations",
+                                           ros_parameters_[group].publish_period, 0, JOG_CALCS_PRIORITY,
+                                           [this, jog_calcs, groups]() {
+                                             jog_calcs->step();
+                                             if (jog_calcs->isIdle())
+                                               pauseJogging(groups);
+                                           }));
+    jog_task_ids_[group] = task_ids_.back();
+  }
+  for (std::size_t pair = 0; pair < coordinated_pairs_.size(); ++pair)
+  {
+    const jog_arm_parameters& first = ros_parameters_[coordinated_pairs_[pair].first];
+    const jog_arm_parameters& second = ros_parameters_[coordinated_pairs_[pair].second];
+    CoordinatedJogCalcs* coordinated_jog_calcs = coordinated_jog_calcs_[pair].get();
+    const std::vector<std::size_t> groups = { coordinated_pairs_[pair].first, coordinated_pairs_[pair].second };
+    task_ids_.push_back(executor_->addTask(
+        first.move_group_name + " and " + second.move_group_name + " jog calculations", first.publish_period, 0,
+        JOG_CALCS_PRIORITY, [this, coordinated_jog_calcs, groups]() {
+          coordinated_jog_calcs->step();
+          if (coordinated_jog_calcs->isIdle())
+            pauseJogging(groups);
+        }));
+    jog_task_ids_[groups[0]] = task_ids_.back();
+    jog_task_ids_[groups[1]] = task_ids_.back();
+  }
+  pthread_mutex_unlock(&idle_mutex_);
+  if (collision_check_->isEnabled())
+  {
+    CollisionCheck* collision_check = collision_check_.get();
+    collision_check_task_id_ = executor_->addTask("collision check", collision_check_->getPeriod(), 0,
+                                                  COLLISION_CHECK_PRIORITY,
+                                                  [collision_check]() { collision_check->step(); });
+    task_ids_.push_back(collision_check_task_id_);
+  }
+  reported_overruns_.assign(task_ids_.size(), 0);
+  telemetry_task_id_ = executor_->addTask("telemetry", TELEMETRY_PERIOD, 0, TELEMETRY_PRIORITY,
+                                          [this]() { reportTelemetry(); });
+  started_ = true;
+
+  if (!executor_->start())
+  {
+    ROS_FATAL_STREAM_NAMED(NODE_NAME, "Creating the executor threads failed");
+    stop();
+    return false;
+  }
 
-  // Wait for low pass filters to stabilize
-  ros::Duration(10 * ros_parameters_.publish_period).sleep();
+  // Read joysticks directly, rather than through joy_node and a converter node
+  direct_input_mappings_.resize(ros_parameters_.size());
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
+  {
+    const jog_arm_parameters& parameters = ros_parameters_[group];
+    if (!parameters.direct_input)
+      continue;
 
-  ros::Rate main_rate(1. / ros_parameters_.publish_period);
+    if (!readJoyMapping(ros::NodeHandle(nh_, parameter_namespaces_[group] + "/direct_input"),
+                        direct_input_mappings_[group]))
+    {
+      stop();
+      return false;
+    }
+    direct_inputs_.emplace_back(new EvdevJoystick(
+        parameters.direct_input_device,
+        std::min(DIRECT_INPUT_REPEAT_PERIOD, 0.5 * parameters.incoming_command_timeout),
+        [this, group](const std::vector<float>& axes, const std::vector<int32_t>& buttons) {
+          return directInputCB(axes, buttons, group);
+        }));
+    if (!direct_inputs_.back()->start())
+    {
+      stop();
+      return false;
+    }
+  }
+
+  // Most parameters can be changed while running. Set them, then call this service.
+  reload_parameters_server_ =
+      ros::NodeHandle("~").advertiseService("reload_parameters", &JogROSInterface::reloadParametersCB, this);
+
+  // Don't wait for joints or commands here. Each move group starts jogging once it has both.
+  ROS_INFO_STREAM_NAMED(NODE_NAME, "Started in " << (ros::WallTime::now() - start_time).toSec()
+                                                 << " s. Waiting for joints and a first command.");
+
+  return true;
+}
+
+// Publish until ROS shuts down or stop() is called
+void JogROSInterface::run()
+{
+  if (!started_)
+    return;
 
-  while (ros::ok())
+  ros::Rate main_rate(1. / min_publish_period_);
+
+  while (ros::ok() && !isStopRequested(shared_variables_))
   {
+    // Nothing to publish. Sleep until a callback, e.g. a new command, is due.
+    if (isIdle())
+    {
+      ros::getGlobalCallbackQueue()->callAvailable(ros::WallDuration(IDLE_SPIN_TIMEOUT));
+      continue;
+    }
+
     ros::spinOnce();
+    publishCommands();
+    main_rate.sleep();
+  }
+}
 
-    pthread_mutex_lock(&shared_variables_.new_traj_mutex);
-    trajectory_msgs::JointTrajectory new_traj = shared_variables_.new_traj;
-    pthread_mutex_unlock(&shared_variables_.new_traj_mutex);
+// Publish the most recent trajectory of every move group that is due this cycle
+void JogROSInterface::publishCommands()
+{
+  if (!started_)
+    return;
+
+  for (std::size_t group = 0; group < shared_variables_.size(); ++group)
+  {
+    if (publish_cycle_ % publish_divisors_[group] != 0)
+      continue;
+
+    const jog_arm_parameters& parameters = getSharedParameters(group);
+    jog_arm_shared& shared_variables = shared_variables_[group];
+
+    // Assigning keeps the storage of the previous cycle
+    JogTrajectory& new_traj = outgoing_trajs_[group];
+    pthread_mutex_lock(&shared_variables.new_traj_mutex);
+    new_traj = shared_variables.new_traj;
+    pthread_mutex_unlock(&shared_variables.new_traj_mutex);
 
     // Check for stale cmds
-    pthread_mutex_lock(&shared_variables_.incoming_cmd_stamp_mutex);
-    if ((ros::Time::now() - shared_variables_.incoming_cmd_stamp) <
-        ros::Duration(ros_parameters_.incoming_command_timeout))
+    pthread_mutex_lock(&shared_variables.incoming_cmd_stamp_mutex);
+    if ((ros::Time::now() - shared_variables.incoming_cmd_stamp) < ros::Duration(parameters.incoming_command_timeout))
     {
       // Mark that incoming commands are not stale
-      pthread_mutex_lock(&shared_variables_.command_is_stale_mutex);
-      shared_variables_.command_is_stale = false;
-      pthread_mutex_unlock(&shared_variables_.command_is_stale_mutex);
+      pthread_mutex_lock(&shared_variables.command_is_stale_mutex);
+      shared_variables.command_is_stale = false;
+      pthread_mutex_unlock(&shared_variables.command_is_stale_mutex);
     }
     else
     {
-      pthread_mutex_lock(&shared_variables_.command_is_stale_mutex);
-      shared_variables_.command_is_stale = true;
-      pthread_mutex_unlock(&shared_variables_.command_is_stale_mutex);
+      pthread_mutex_lock(&shared_variables.command_is_stale_mutex);
+      shared_variables.command_is_stale = true;
+      pthread_mutex_unlock(&shared_variables.command_is_stale_mutex);
     }
-    pthread_mutex_unlock(&shared_variables_.incoming_cmd_stamp_mutex);
+    pthread_mutex_unlock(&shared_variables.incoming_cmd_stamp_mutex);
 
     // Publish the most recent trajectory, unless the jogging calculation thread
     // tells not to
-    pthread_mutex_lock(&shared_variables_.ok_to_publish_mutex);
-    if (shared_variables_.ok_to_publish)
+    pthread_mutex_lock(&shared_variables.ok_to_publish_mutex);
+    if (shared_variables.ok_to_publish)
     {
       // Put the outgoing msg in the right format
       // (trajectory_msgs/JointTrajectory or std_msgs/Float64MultiArray).
-      if (ros_parameters_.command_out_type == "trajectory_msgs/JointTrajectory")
+      if (parameters.command_out_type == "trajectory_msgs/JointTrajectory")
       {
         new_traj.header.stamp = ros::Time::now();
-        outgoing_cmd_pub.publish(new_traj);
+        serialized_trajs_[group].update(new_traj);
+        outgoing_cmd_pubs_[group].publish(serialized_trajs_[group]);
       }
-      else if (ros_parameters_.command_out_type == "std_msgs/Float64MultiArray")
+      else if (parameters.command_out_type == "std_msgs/Float64MultiArray")
       {
         std_msgs::Float64MultiArray joints;
-        if (ros_parameters_.publish_joint_positions)
-          joints.data = new_traj.points[0].positions;
-        else if (ros_parameters_.publish_joint_velocities)
-          joints.data = new_traj.points[0].velocities;
-        outgoing_cmd_pub.publish(joints);
+        if (parameters.publish_joint_positions)
+          joints.data.assign(new_traj.points[0].positions.begin(), new_traj.points[0].positions.end());
+        else if (parameters.publish_joint_velocities)
+          joints.data.assign(new_traj.points[0].velocities.begin(), new_traj.points[0].velocities.end());
+        outgoing_cmd_pubs_[group].publish(joints);
       }
     }
     else
     {
-      ROS_WARN_STREAM_THROTTLE_NAMED(2, NODE_NAME, "Stale or zero command. "
-                                                   "Try a larger 'incoming_command_timeout' parameter?");
+      ROS_WARN_STREAM_THROTTLE_NAMED(2, NODE_NAME, "Stale or zero command for move group '"
+                                                       << parameters.move_group_name
+                                                       << "'. Try a larger 'incoming_command_timeout' parameter?");
+    }
+    pthread_mutex_unlock(&shared_variables.ok_to_publish_mutex);
+  }
+
+  ++publish_cycle_;
+}
+
+// Stop the calculations and wait for any that are running
+void JogROSInterface::stop()
+{
+  for (jog_arm_shared& shared_variables : shared_variables_)
+  {
+    pthread_mutex_lock(&shared_variables.stop_requested_mutex);
+    shared_variables.stop_requested = true;
+    pthread_mutex_unlock(&shared_variables.stop_requested_mutex);
+  }
+
+  // The joysticks wake the jogging tasks, so stop them first
+  direct_inputs_.clear();
+
+  if (started_)
+  {
+    executor_->removeTask(telemetry_task_id_);
+    for (std::size_t task_id : task_ids_)
+      executor_->removeTask(task_id);
+  }
+  task_ids_.clear();
+
+  for (ros::Subscriber& subscriber : subscribers_)
+    subscriber.shutdown();
+  subscribers_.clear();
+  reload_parameters_server_.shutdown();
+
+  coordinated_jog_calcs_.clear();
+  jog_calcs_.clear();
+  collision_check_.reset();
+  // publishCommands() may still be called after stop(). Don't leave it pointers to freed blocks.
+  for (jog_arm_shared& shared_variables : shared_variables_)
+    shared_variables.parameters.store(nullptr, std::memory_order_release);
+  shared_parameters_.clear();
+
+  started_ = false;
+}
+
+const std::vector<jog_arm_parameters>& JogROSInterface::getParameters() const
+{
+  return ros_parameters_;
+}
+
+// Share a copy of ros_parameters_[group] with the worker threads
+void JogROSInterface::shareParameters(const std::size_t group)
+{
+  shared_parameters_.emplace_back(new jog_arm_parameters(ros_parameters_[group]));
+  shared_variables_[group].parameters.store(shared_parameters_.back().get(), std::memory_order_release);
+}
+
+// The latest shared parameters of a move group. Unlike ros_parameters_, safe to read from any thread.
+const jog_arm_parameters& JogROSInterface::getSharedParameters(const std::size_t group) const
+{
+  return *shared_variables_[group].parameters.load(std::memory_order_acquire);
+}
+
+// Re-read every parameter namespace. Share the new parameters only if all of them are valid.
+bool JogROSInterface::reloadParametersCB(std_srvs::Trigger::Request& req, std_srvs::Trigger::Response& res)
+{
+  res.success = false;
+  if (!started_)
+  {
+    res.message = "The server is not running";
+    return true;
+  }
+
+  std::vector<jog_arm_parameters> reloaded(ros_parameters_.size());
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
+  {
+    if (readParameterValues(nh_, parameter_namespaces_[group], reloaded[group]) ||
+        !validateParameters(reloaded[group]))
+    {
+      res.message = "Parameters in '" + parameter_namespaces_[group] + "' are missing or invalid. See the log.";
+      return true;
     }
-    pthread_mutex_unlock(&shared_variables_.ok_to_publish_mutex);
 
-    main_rate.sleep();
+    const std::string fixed_parameter = getFixedParameterChange(ros_parameters_[group], reloaded[group]);
+    if (!fixed_parameter.empty())
+    {
+      res.message = "Parameter '" + fixed_parameter + "' in '" + parameter_namespaces_[group] +
+                    "' can't change while running. Restart the server to change it.";
+      return true;
+    }
+  }
+
+  for (std::size_t group = 0; group < ros_parameters_.size(); ++group)
+  {
+    ros_parameters_[group] = reloaded[group];
+    shareParameters(group);
   }
 
-  (void)pthread_join(joggingThread, nullptr);
-  (void)pthread_join(collisionThread, nullptr);
+  if (collision_check_->isEnabled())
+  {
+    std::vector<const jog_arm_parameters*> parameters;
+    for (const jog_arm_parameters& group_parameters : ros_parameters_)
+      parameters.push_back(&group_parameters);
+    executor_->setPeriod(collision_check_task_id_, getCollisionCheckPeriod(parameters), 0);
+  }
+
+  ROS_INFO_NAMED(NODE_NAME, "Reloaded the parameters");
+  res.success = true;
+  return true;
 }
 
-// A separate thread for the heavy jogging calculations.
-void* JogROSInterface::jogCalcThread(void*)
+// Pause the task that jogs these move groups, unless a command arrived. Called by the task itself.
+void JogROSInterface::pauseJogging(const std::vector<std::size_t>& groups)
 {
-  jog_arm::JogCalcs ja(ros_parameters_, shared_variables_, model_loader_ptr_);
-  return nullptr;
+  pthread_mutex_lock(&idle_mutex_);
+
+  // The callbacks set the command flags and stamp before they check for idle tasks, so a
+  // command that arrived during this cycle shows up here
+  for (std::size_t group : groups)
+  {
+    if (hasActiveCommand(group))
+    {
+      pthread_mutex_unlock(&idle_mutex_);
+      return;
+    }
+  }
+
+  executor_->pauseTask(jog_task_ids_[groups.front()]);
+  for (std::size_t group : groups)
+  {
+    idle_groups_[group] = true;
+    jog_calcs_[group]->enterIdle();
+  }
+
+  if (std::find(idle_groups_.begin(), idle_groups_.end(), false) == idle_groups_.end())
+  {
+    if (collision_check_->isEnabled())
+      executor_->pauseTask(collision_check_task_id_);
+    executor_->pauseTask(telemetry_task_id_);
+    ROS_DEBUG_NAMED(NODE_NAME, "Idle");
+  }
+
+  pthread_mutex_unlock(&idle_mutex_);
+}
+
+// Resume the task that jogs a move group, e.g. because a command arrived
+void JogROSInterface::resumeJogging(const std::size_t group)
+{
+  pthread_mutex_lock(&idle_mutex_);
+  if (idle_groups_[group])
+  {
+    if (std::find(idle_groups_.begin(), idle_groups_.end(), false) == idle_groups_.end())
+    {
+      if (collision_check_->isEnabled())
+        executor_->resumeTask(collision_check_task_id_);
+      executor_->resumeTask(telemetry_task_id_);
+    }
+
+    // Both move groups of a coordinated pair share the task
+    idle_groups_[group] = false;
+    if (partner_groups_[group] >= 0)
+      idle_groups_[partner_groups_[group]] = false;
+    executor_->resumeTask(jog_task_ids_[group]);
+  }
+  pthread_mutex_unlock(&idle_mutex_);
 }
 
-// A separate thread for collision checking.
-void* JogROSInterface::CollisionCheckThread(void*)
+// True if the latest command of a move group is non-zero and not timed out. Any kind of command counts:
+// Cartesian, joint, JogFrame, pose or coordinated. A publisher that died without sending zeros times out.
+bool JogROSInterface::hasActiveCommand(const std::size_t group)
 {
-  jog_arm::CollisionCheckThread cc(ros_parameters_, shared_variables_, model_loader_ptr_);
-  return nullptr;
+  jog_arm_shared& shared_variables = shared_variables_[group];
+
+  pthread_mutex_lock(&shared_variables.incoming_cmd_stamp_mutex);
+  const bool stale = (ros::Time::now() - shared_variables.incoming_cmd_stamp) >=
+                     ros::Duration(getSharedParameters(group).incoming_command_timeout);
+  pthread_mutex_unlock(&shared_variables.incoming_cmd_stamp_mutex);
+  if (stale)
+    return false;
+
+  pthread_mutex_lock(&shared_variables.zero_cartesian_cmd_flag_mutex);
+  pthread_mutex_lock(&shared_variables.zero_joint_cmd_flag_mutex);
+  const bool zero_command = shared_variables.zero_cartesian_cmd_flag && shared_variables.zero_joint_cmd_flag;
+  pthread_mutex_unlock(&shared_variables.zero_joint_cmd_flag_mutex);
+  pthread_mutex_unlock(&shared_variables.zero_cartesian_cmd_flag_mutex);
+  return !zero_command;
+}
+
+// True if every move group is idle, so there is nothing to publish
+bool JogROSInterface::isIdle()
+{
+  pthread_mutex_lock(&idle_mutex_);
+  const bool idle = std::find(idle_groups_.begin(), idle_groups_.end(), false) == idle_groups_.end();
+  pthread_mutex_unlock(&idle_mutex_);
+  return idle;
+}
+
+// Warn about tasks that missed their deadlines since the last report
+void JogROSInterface::reportTelemetry()
+{
+  for (std::size_t i = 0; i < task_ids_.size(); ++i)
+  {
+    const PeriodicTaskExecutor::TaskStatistics statistics = executor_->getStatistics(task_ids_[i]);
+    const uint64_t new_overruns = statistics.overruns - reported_overruns_[i];
+    reported_overruns_[i] = statistics.overruns;
+
+    if (new_overruns > 0)
+      ROS_WARN_STREAM_NAMED(NODE_NAME, "Task '" << statistics.name << "' overran its deadline " << new_overruns
+                                                << " times in the last " << TELEMETRY_PERIOD
+                                                << " s. Longest run: " << statistics.max_duration << " s");
+    if (statistics.runs > 0)
+      ROS_DEBUG_STREAM_NAMED(NODE_NAME, "Task '" << statistics.name << "': " << statistics.runs
+                                                 << " runs, mean duration "
+                                                 << statistics.total_duration / statistics.runs << " s");
+  }
 }
 
 // Constructor for the class that handles collision checking
-CollisionCheckThread::CollisionCheckThread(
-    const jog_arm_parameters& parameters, jog_arm_shared& shared_variables,
-    const std::unique_ptr<robot_model_loader::RobotModelLoader>& model_loader_ptr)
+CollisionCheck::CollisionCheck(const std::vector<jog_arm_parameters>& parameters,
+                               std::deque<jog_arm_shared>& shared_variables,
+                               const std::vector<std::pair<std::size_t, std::size_t>>& coordinated_pairs,
+                               const std::shared_ptr<robot_model_loader::RobotModelLoader>& model_loader_ptr)
+  : shared_variables_(shared_variables)
 {
-  // If user specified true in yaml file
-  if (parameters.collision_check)
+  // The move groups where the user specified true in yaml file
+  for (std::size_t group = 0; group < parameters.size(); ++group)
   {
-    // MoveIt Setup
-    // Wait for model_loader_ptr to be non-null.
-    while (ros::ok() && !model_loader_ptr)
+    if (parameters[group].collision_check)
     {
-      ROS_WARN_THROTTLE_NAMED(5, NODE_NAME, "Waiting for a non-null robot_model_loader pointer");
-      ros::Duration(0.1).sleep();
+      groups_.push_back(group);
+      parameters_.push_back(shared_variables_[group].parameters.load(std::memory_order_acquire));
     }
-    const robot_model::RobotModelPtr& kinematic_model = model_loader_ptr->getModel();
-    planning_scene::PlanningScene planning_scene(kinematic_model);
-    collision_detection::CollisionRequest collision_request;
-    collision_request.group_name = parameters.move_group_name;
-    collision_request.distance = true;
-    collision_detection::CollisionResult collision_result;
-    robot_state::RobotState& current_state = planning_scene.getCurrentStateNonConst();
-    moveit::planning_interface::PlanningSceneInterface planning_scene_interface;
-
-    // Wait for initial messages
-    ROS_INFO_NAMED(NODE_NAME, "Waiting for first joint msg.");
-    ros::topic::waitForMessage<sensor_msgs::JointState>(parameters.joint_topic);
-    ROS_INFO_NAMED(NODE_NAME, "Received first joint msg.");
-
-    ROS_INFO_NAMED(NODE_NAME, "Waiting for first command msg.");
-    ros::topic::waitForMessage<geometry_msgs::TwistStamped>(parameters.cartesian_command_in_topic);
-    ROS_INFO_NAMED(NODE_NAME, "Received first command msg.");
-
-    // A very low cutoff frequency
-    jog_arm::LowPassFilter velocity_scale_filter(20);
-    // Assume no scaling, initially
-    velocity_scale_filter.reset(1);
-    ros::Rate collision_rate(parameters.collision_check_rate);
-
-    /////////////////////////////////////////////////
-    // Spin while checking collisions
-    /////////////////////////////////////////////////
-    while (ros::ok())
-    {
-      sensor_msgs::JointState jts = shared_variables.joints;
+  }
 
-      for (std::size_t i = 0; i < jts.position.size(); ++i)
-        current_state.setJointPositions(jts.name[i], &jts.position[i]);
+  if (groups_.empty())
+    return;
+  period_ = getCollisionCheckPeriod(parameters_);
 
-      // process collision objects in scene
-      std::map<std::string, moveit_msgs::CollisionObject> c_objects_map = planning_scene_interface.getObjects();
-      for (auto& kv : c_objects_map)
+  // MoveIt Setup
+  const robot_model::RobotModelPtr& kinematic_model = model_loader_ptr->getModel();
+  planning_scene_.reset(new planning_scene::PlanningScene(kinematic_model));
+  for (const jog_arm_parameters* group_parameters : parameters_)
+    joint_model_groups_.push_back(kinematic_model->getJointModelGroup(group_parameters->move_group_name));
+
+  // Move groups that are jogged together share one query of the whole robot. It also
+  // covers their distance to each other.
+  std::vector<bool> has_query(groups_.size(), false);
+  for (std::size_t i = 0; i < groups_.size(); ++i)
+  {
+    if (has_query[i])
+      continue;
+
+    CollisionQuery query;
+    query.request.group_name = parameters_[i]->move_group_name;
+    query.request.distance = true;
+    // Only gathered when in collision. One names the link for the status.
+    query.request.contacts = true;
+    query.request.max_contacts = 1;
+    query.channels.push_back(i);
+    has_query[i] = true;
+
+    for (const std::pair<std::size_t, std::size_t>& pair : coordinated_pairs)
+    {
+      std::size_t partner;
+      if (pair.first == groups_[i])
+        partner = pair.second;
+      else if (pair.second == groups_[i])
+        partner = pair.first;
+      else
+        continue;
+
+      for (std::size_t j = i + 1; j < groups_.size(); ++j)
       {
-        planning_scene.processCollisionObjectMsg(kv.second);
+        if (groups_[j] == partner && !has_query[j])
+        {
+          query.request.group_name = "";
+          query.channels.push_back(j);
+          has_query[j] = true;
+        }
       }
+    }
+    collision_queries_.push_back(query);
+  }
+  planning_scene_interface_.reset(new moveit::planning_interface::PlanningSceneInterface);
+
+  // One channel per move group
+  velocity_scale_filters_.reset(new LowPassFilterBank(groups_.size(), getVelocityScaleFilterSpec(period_)));
+  // Assume no scaling, initially
+  velocity_scale_filters_->reset(1.);
+  velocity_scales_.resize(groups_.size());
+  collision_status_.resize(groups_.size());
+  collision_links_.resize(groups_.size());
+}
+
+bool CollisionCheck::isEnabled() const
+{
+  return !groups_.empty();
+}
+
+double CollisionCheck::getPeriod() const
+{
+  return period_;
+}
+
+// Check collisions once and share the velocity scales
+void CollisionCheck::step()
+{
+  if (groups_.empty())
+    return;
+
+  // Switch to reloaded parameters between cycles
+  for (std::size_t i = 0; i < groups_.size(); ++i)
+    parameters_[i] = shared_variables_[groups_[i]].parameters.load(std::memory_order_acquire);
+  const double period = getCollisionCheckPeriod(parameters_);
+  if (period != period_)
+  {
+    period_ = period;
+    velocity_scale_filters_->setSpec(getVelocityScaleFilterSpec(period_));
+  }
 
-      collision_result.clear();
-      planning_scene.checkCollision(collision_request, collision_result);
+  robot_state::RobotState& current_state = planning_scene_->getCurrentStateNonConst();
+  for (std::size_t i = 0; i < groups_.size(); ++i)
+  {
+    jog_arm_shared& shared_variables = shared_variables_[groups_[i]];
+    pthread_mutex_lock(&shared_variables.joints_mutex);
+    const bool has_joints = shared_variables.joints.complete;
+    if (has_joints)
+      current_state.setJointGroupPositions(joint_model_groups_[i], shared_variables.joints.position);
+    pthread_mutex_unlock(&shared_variables.joints_mutex);
+
+    // Wait until every move group has joints. The default state could be in collision.
+    if (!has_joints)
+      return;
+  }
+
+  // process collision objects in scene
+  std::map<std::string, moveit_msgs::CollisionObject> c_objects_map = planning_scene_interface_->getObjects();
+  for (auto& kv : c_objects_map)
+  {
+    planning_scene_->processCollisionObjectMsg(kv.second);
+  }
+
+  std::vector<bool> in_collision(groups_.size());
+  for (const CollisionQuery& query : collision_queries_)
+  {
+    collision_result_.clear();
+    planning_scene_->checkCollision(query.request, collision_result_);
+
+    for (std::size_t i : query.channels)
+    {
+      const jog_arm_parameters& group_parameters = *parameters_[i];
+      in_collision[i] = collision_result_.collision;
+      collision_links_[i].clear();
+      if (collision_result_.collision && !collision_result_.contacts.empty())
+        collision_links_[i] = collision_result_.contacts.begin()->first.first;
 
       // Scale robot velocity according to collision proximity and user-defined
       // thresholds.
       // I scaled exponentially (cubic power) so velocity drops off quickly
       // after the threshold.
       // Proximity decreasing --> decelerate
-      double velocity_scale = 1;
+      velocity_scales_[i] = 1;
 
       // Ramp velocity down linearly when collision proximity is between
       // lower_collision_proximity_threshold and
       // hard_stop_collision_proximity_threshold
-      if ((collision_result.distance > parameters.hard_stop_collision_proximity_threshold) &&
-          (collision_result.distance < parameters.lower_collision_proximity_threshold))
+      if ((collision_result_.distance > group_parameters.hard_stop_collision_proximity_threshold) &&
+          (collision_result_.distance < group_parameters.lower_collision_proximity_threshold))
       {
         // scale = k*(proximity-hard_stop_threshold)^3
-        velocity_scale =
-            64000. * pow(collision_result.distance - parameters.hard_stop_collision_proximity_threshold, 3);
+        velocity_scales_[i] =
+            64000. * pow(collision_result_.distance - group_parameters.hard_stop_collision_proximity_threshold, 3);
       }
-      //else if (collision_result.distance < parameters.hard_stop_collision_proximity_threshold)
-      //  velocity_scale = 0;
 
-      velocity_scale = velocity_scale_filter.filter(velocity_scale);
-      // Put a ceiling and a floor on velocity_scale
-      if (velocity_scale > 1)
-        velocity_scale = 1;
-      else if (velocity_scale < 0.05)
-        velocity_scale = 0.05;
+      if (in_collision[i])
+        collision_status_[i] = jog_msgs::JogStatus::IN_COLLISION;
+      else if (velocity_scales_[i] < 1)
+        collision_status_[i] = jog_msgs::JogStatus::DECELERATE_FOR_COLLISION;
+      else
+        collision_status_[i] = jog_msgs::JogStatus::OK;
+      //else if (collision_result_.distance < group_parameters.hard_stop_collision_proximity_threshold)
+      //  velocity_scales_[i] = 0;
+    }
+  }
 
-      // Very slow if actually in collision
-      if (collision_result.collision)
-        velocity_scale = 0.02;
+  velocity_scale_filters_->filter(velocity_scales_.data());
 
-      pthread_mutex_lock(&shared_variables.collision_velocity_scale_mutex);
-      shared_variables.collision_velocity_scale = velocity_scale;
-      pthread_mutex_unlock(&shared_variables.collision_velocity_scale_mutex);
+  for (std::size_t i = 0; i < groups_.size(); ++i)
+  {
+    double velocity_scale = velocity_scales_[i];
+    // Put a ceiling and a floor on velocity_scale
+    if (velocity_scale > 1)
+      velocity_scale = 1;
+    else if (velocity_scale < 0.05)
+      velocity_scale = 0.05;
+
+    // Very slow if actually in collision
+    if (in_collision[i])
+      velocity_scale = 0.02;
+
+    jog_arm_shared& group_shared_variables = shared_variables_[groups_[i]];
+    pthread_mutex_lock(&group_shared_variables.collision_velocity_scale_mutex);
+    group_shared_variables.collision_velocity_scale = velocity_scale;
+    group_shared_variables.collision_status = collision_status_[i];
+    group_shared_variables.collision_link = collision_links_[i];
+    pthread_mutex_unlock(&group_shared_variables.collision_velocity_scale_mutex);
+  }
+}
 
-      collision_rate.sleep();
-    }
+// Constructor for the class that jogs two move groups together
+CoordinatedJogCalcs::CoordinatedJogCalcs(JogCalcs& first, JogCalcs& second,
+                                         jog_arm_coordinated_shared& shared_variables)
+  : first_(first), second_(second), shared_variables_(shared_variables)
+{
+  // Columns of the stacked Jacobian. A joint in both groups gets one column.
+  for (const std::string& name : first_.jt_state_.name)
+  {
+    first_columns_.push_back(joint_names_.size());
+    joint_names_.push_back(name);
+  }
+  for (const std::string& name : second_.jt_state_.name)
+  {
+    std::vector<std::string>::const_iterator column = std::find(joint_names_.begin(), joint_names_.end(), name);
+    second_columns_.push_back(static_cast<std::size_t>(column - joint_names_.begin()));
+    if (column == joint_names_.end())
+      joint_names_.push_back(name);
   }
 }
 
+// One cycle. Without a coordinated command, each move group jogs on its own.
+void CoordinatedJogCalcs::step()
+{
+  if (!isCoordinated(first_.shared_variables_) || !isCoordinated(second_.shared_variables_))
+  {
+    first_.step();
+    second_.step();
+    return;
+  }
+
+  if (!first_.beginStep() || !second_.beginStep())
+    return;
+
+  if ((first_.zero_velocity_count_ <= NUM_ZERO_CYCLES_TO_PUBLISH) ||
+      (second_.zero_velocity_count_ <= NUM_ZERO_CYCLES_TO_PUBLISH))
+  {
+    pthread_mutex_lock(&shared_variables_.command_mutex);
+    geometry_msgs::TwistStamped object_deltas = shared_variables_.object_command;
+    geometry_msgs::TwistStamped relative_deltas = shared_variables_.relative_command;
+    pthread_mutex_unlock(&shared_variables_.command_mutex);
+
+    if (!coordinatedJogCalcs(object_deltas, relative_deltas))
+      return;
+  }
+
+  first_.finishStep();
+  second_.finishStep();
+}
+
+bool CoordinatedJogCalcs::isIdle() const
+{
+  return first_.isIdle() && second_.isIdle();
+}
+
+bool CoordinatedJogCalcs::isCoordinated(jog_arm_shared& shared_variables) const
+{
+  pthread_mutex_lock(&shared_variables.coordinated_cmd_flag_mutex);
+  bool coordinated = shared_variables.coordinated_cmd_flag;
+  pthread_mutex_unlock(&shared_variables.coordinated_cmd_flag_mutex);
+  return coordinated;
+}
+
+// Solve both move groups in one step
+bool CoordinatedJogCalcs::coordinatedJogCalcs(const geometry_msgs::TwistStamped& object_cmd,
+                                              const geometry_msgs::TwistStamped& relative_cmd)
+{
+  if (!first_.isValidCartesianCommand(object_cmd) || !first_.isValidCartesianCommand(relative_cmd))
+    return 0;
+
+  first_.kinematic_state_->setVariableValues(first_.jt_state_);
+  second_.kinematic_state_->setVariableValues(second_.jt_state_);
+
+  geometry_msgs::TwistStamped object_twist, relative_twist;
+  if (!first_.transformToPlanningFrame(object_cmd, object_twist) ||
+      !first_.transformToPlanningFrame(relative_cmd, relative_twist))
+    return 0;
+
+  const Eigen::VectorXd object_delta = first_.scaleCartesianCommand(object_twist);
+  const Eigen::VectorXd relative_delta = first_.scaleCartesianCommand(relative_twist);
+
+  // The object frame is halfway between the end effectors
+  const Eigen::Vector3d first_position =
+      first_.kinematic_state_->getGlobalLinkTransform(first_.joint_model_group_->getLinkModels().back()).translation();
+  const Eigen::Vector3d second_position =
+      second_.kinematic_state_->getGlobalLinkTransform(second_.joint_model_group_->getLinkModels().back()).translation();
+  const Eigen::Vector3d object_position = 0.5 * (first_position + second_position);
+
+  // Split the commands between the end effectors. The object's rotation moves each
+  // end effector around the object frame. Each one takes half of the relative motion.
+  const Eigen::Vector3d object_linear = object_delta.head<3>();
+  const Eigen::Vector3d object_angular = object_delta.tail<3>();
+  const Eigen::Vector3d relative_linear = relative_delta.head<3>();
+  const Eigen::Vector3d relative_angular = relative_delta.tail<3>();
+
+  Eigen::VectorXd delta_x(12);
+  delta_x.segment<3>(0) = object_linear - 0.5 * relative_linear + object_angular.cross(first_position - object_position);
+  delta_x.segment<3>(3) = object_angular - 0.5 * relative_angular;
+  delta_x.segment<3>(6) =
+      object_linear + 0.5 * relative_linear + object_angular.cross(second_position - object_position);
+  delta_x.segment<3>(9) = object_angular + 0.5 * relative_angular;
+
+  // Stack the Jacobians of both move groups
+  const Eigen::MatrixXd first_jacobian = first_.kinematic_state_->getJacobian(first_.joint_model_group_);
+  const Eigen::MatrixXd second_jacobian = second_.kinematic_state_->getJacobian(second_.joint_model_group_);
+  Eigen::MatrixXd jacobian = Eigen::MatrixXd::Zero(12, joint_names_.size());
+  for (std::size_t i = 0; i < first_columns_.size(); ++i)
+    jacobian.block<6, 1>(0, first_columns_[i]) = first_jacobian.col(i);
+  for (std::size_t i = 0; i < second_columns_.size(); ++i)
+    jacobian.block<6, 1>(6, second_columns_[i]) = second_jacobian.col(i);
+
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd(jacobian, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  Eigen::VectorXd delta_theta =
+      first_.pseudoInverse(svd.matrixU(), svd.matrixV(), svd.singularValues().asDiagonal()) * delta_x;
+
+  // Scale uniformly, so the relative pose is kept
+  first_.enforceJointVelocityLimits(delta_theta);
+  second_.enforceJointVelocityLimits(delta_theta);
+
+  Eigen::VectorXd first_delta_theta(first_columns_.size());
+  for (std::size_t i = 0; i < first_columns_.size(); ++i)
+    first_delta_theta[i] = delta_theta[first_columns_[i]];
+  Eigen::VectorXd second_delta_theta(second_columns_.size());
+  for (std::size_t i = 0; i < second_columns_.size(); ++i)
+    second_delta_theta[i] = delta_theta[second_columns_[i]];
+
+  // If either move group is close to a collision or a singularity, both decelerate
+  first_.raiseCollisionStatus();
+  second_.raiseCollisionStatus();
+  const double velocity_scale =
+      std::min(first_.decelerateForSingularity(first_jacobian, delta_x.head<6>()) *
+                   first_.shared_variables_.collision_velocity_scale,
+               second_.decelerateForSingularity(second_jacobian, delta_x.tail<6>()) *
+                   second_.shared_variables_.collision_velocity_scale);
+
+  if (!first_.applyJointIncrements(first_delta_theta, velocity_scale) ||
+      !second_.applyJointIncrements(second_delta_theta, velocity_scale))
+    return 0;
+
+  // If either move group reaches a joint limit, both halt
+  const bool first_within_bounds = first_.checkIfJointsWithinBounds(first_.new_traj_);
+  const bool second_within_bounds = second_.checkIfJointsWithinBounds(second_.new_traj_);
+  if (!first_within_bounds || !second_within_bounds)
+  {
+    first_.halt(first_.new_traj_);
+    second_.halt(second_.new_traj_);
+  }
+  first_.publishWarning(!first_within_bounds || !second_within_bounds);
+  second_.publishWarning(!first_within_bounds || !second_within_bounds);
+
+  // Each move group reports why the other one stopped it
+  if (!second_within_bounds)
+    first_.raiseStatus(second_.status_.code, second_.status_.joint_name, second_.status_.link_name);
+  if (!first_within_bounds)
+    second_.raiseStatus(first_.status_.code, first_.status_.joint_name, first_.status_.link_name);
+
+  // If using Gazebo simulator, insert redundant points
+  if (first_.parameters_.gazebo)
+    first_.insertRedundantPointsIntoTrajectory(first_.new_traj_, GAZEBO_REDUNTANT_MESSAGE_COUNT);
+  if (second_.parameters_.gazebo)
+    second_.insertRedundantPointsIntoTrajectory(second_.new_traj_, GAZEBO_REDUNTANT_MESSAGE_COUNT);
+
+  return 1;
+}
+
 // Constructor for the class that handles jogging calculations
 JogCalcs::JogCalcs(const jog_arm_parameters& parameters, jog_arm_shared& shared_variables,
-                   const std::unique_ptr<robot_model_loader::RobotModelLoader>& model_loader_ptr)
-  : move_group_(parameters.move_group_name)
+                   const std::shared_ptr<robot_model_loader::RobotModelLoader>& model_loader_ptr,
+                   tf::TransformListener& listener)
+  : listener_(listener), shared_variables_(shared_variables)
 {
   parameters_ = parameters;
+  shared_parameters_ = shared_variables_.parameters.load(std::memory_order_acquire);
 
   // Publish collision status
   warning_pub_ = nh_.advertise<std_msgs::Bool>(parameters_.warning_topic, 1);
+  status_pub_ = nh_.advertise<jog_msgs::JogStatus>(parameters_.status_topic, 1, true);
+  status_.group_name = parameters_.move_group_name;
 
   // MoveIt Setup
-  // Wait for model_loader_ptr to be non-null.
-  while (ros::ok() && !model_loader_ptr)
-  {
-    ROS_WARN_THROTTLE_NAMED(5, NODE_NAME, "Waiting for a non-null robot_model_loader pointer");
-    ros::Duration(0.1).sleep();
-  }
   const robot_model::RobotModelPtr& kinematic_model = model_loader_ptr->getModel();
   kinematic_state_ = std::make_shared<robot_state::RobotState>(kinematic_model);
   kinematic_state_->setToDefaultValues();
 
   joint_model_group_ = kinematic_model->getJointModelGroup(parameters_.move_group_name);
+  const robot_model::LinkModel* group_base_link = joint_model_group_->getCommonRoot()->getParentLinkModel();
+  group_base_frame_ = group_base_link ? group_base_link->getName() : kinematic_model->getModelFrame();
+
+  ik_available_ = static_cast<bool>(joint_model_group_->getSolverInstance());
+  if (parameters_.correct_drift && parameters_.drift_correction_ik_period > 0. && !ik_available_)
+    ROS_WARN_STREAM_NAMED(NODE_NAME, "Move group '" << parameters_.move_group_name
+                                                    << "' has no kinematics solver. Drift is corrected without IK.");
 
   std::vector<double> dummy_joint_values;
   kinematic_state_->copyJointGroupPositions(joint_model_group_, dummy_joint_values);
 
-  // Wait for initial messages
-  ROS_INFO_NAMED(NODE_NAME, "Waiting for first joint msg.");
-  ros::topic::waitForMessage<sensor_msgs::JointState>(parameters_.joint_topic);
-  ROS_INFO_NAMED(NODE_NAME, "Received first joint msg.");
-
-  ROS_INFO_NAMED(NODE_NAME, "Waiting for first command msg.");
-  ros::topic::waitForMessage<geometry_msgs::TwistStamped>(parameters_.cartesian_command_in_topic);
-  ROS_INFO_NAMED(NODE_NAME, "Received first command msg.");
-
-  resetVelocityFilters();
-
-  jt_state_.name = move_group_.getJointNames();
+  jt_state_.name = joint_model_group_->getVariableNames();
   jt_state_.position.resize(jt_state_.name.size());
   jt_state_.velocity.resize(jt_state_.name.size());
   jt_state_.effort.resize(jt_state_.name.size());
 
   // Low-pass filters for the joint positions & velocities
-  for (size_t i = 0; i < jt_state_.name.size(); ++i)
+  velocity_filters_.reset(new LowPassFilterBank(jt_state_.name.size(), getJointFilterSpec(parameters_)));
+  position_filters_.reset(new LowPassFilterBank(jt_state_.name.size(), getJointFilterSpec(parameters_)));
+
+  resetVelocityFilters();
+
+  measured_velocity_.resize(jt_state_.name.size());
+  if (parameters_.estimate_joint_states)
+    joint_state_estimator_.reset(new JointStateEstimator(jt_state_.name.size(), parameters_.joint_state_estimator_alpha,
+                                                         parameters_.joint_state_estimator_beta));
+
+  // Acceleration limits can come from joint_limits.yaml via robot_description_planning
+  // Position limits center the joints in the null space
+  acceleration_limits_ = Eigen::VectorXd::Zero(jt_state_.name.size());
+  joint_mid_positions_ = Eigen::VectorXd::Zero(jt_state_.name.size());
+  joint_half_ranges_ = Eigen::VectorXd::Zero(jt_state_.name.size());
+  for (std::size_t i = 0; i < jt_state_.name.size(); ++i)
   {
-    velocity_filters_.emplace_back(parameters_.low_pass_filter_coeff);
-    position_filters_.emplace_back(parameters_.low_pass_filter_coeff);
+    const robot_model::VariableBounds& bounds = kinematic_model->getVariableBounds(jt_state_.name[i]);
+    if (bounds.acceleration_bounded_)
+      acceleration_limits_[i] = bounds.max_acceleration_;
+    if (bounds.position_bounded_)
+    {
+      joint_mid_positions_[i] = 0.5 * (bounds.max_position_ + bounds.min_position_);
+      joint_half_ranges_[i] = 0.5 * (bounds.max_position_ - bounds.min_position_);
+    }
+  }
+  start_posture_ = Eigen::VectorXd::Zero(jt_state_.name.size());
+
+  // Velocity limits come from the robot model. Acceleration limits do too, if it has them.
+  if (parameters_.smoothing)
+  {
+    Eigen::VectorXd max_velocity(jt_state_.name.size());
+    Eigen::VectorXd max_acceleration(jt_state_.name.size());
+    for (std::size_t i = 0; i < jt_state_.name.size(); ++i)
+    {
+      const robot_model::VariableBounds& bounds = kinematic_model->getVariableBounds(jt_state_.name[i]);
+      max_velocity[i] = bounds.velocity_bounded_ ? bounds.max_velocity_ : std::numeric_limits<double>::max();
+      max_acceleration[i] =
+          bounds.acceleration_bounded_ ? bounds.max_acceleration_ : parameters_.max_joint_acceleration;
+    }
+    smoother_.reset(new JerkLimitedSmoother(max_velocity, max_acceleration,
+                                            Eigen::VectorXd::Constant(max_velocity.size(), parameters_.max_joint_jerk),
+                                            parameters_.publish_period));
+  }
+
+}
+
+// One cycle of jogging calculations. Returns without waiting if there is nothing to do yet.
+void JogCalcs::step()
+{
+  if (!beginStep())
+    return;
+
+  // If there have not been several consecutive cycles of all zeros and joint
+  // jogging commands are empty
+  if ((zero_velocity_count_ <= NUM_ZERO_CYCLES_TO_PUBLISH) && zero_joint_traj_flag_)
+  {
+    pthread_mutex_lock(&shared_variables_.command_deltas_mutex);
+    geometry_msgs::TwistStamped cartesian_deltas = shared_variables_.command_deltas;
+    const std::string link_name = shared_variables_.command_link;
+    const bool avoid_collisions = shared_variables_.command_avoids_collisions;
+    const bool pose_command = shared_variables_.pose_cmd_flag;
+    geometry_msgs::PoseStamped target_pose;
+    if (pose_command)
+      target_pose = shared_variables_.pose_command;
+    pthread_mutex_unlock(&shared_variables_.command_deltas_mutex);
+
+    if (pose_command)
+    {
+      if (!poseTrackingJogCalcs(target_pose, shared_variables_))
+        return;
+    }
+    else if (!cartesianJogCalcs(cartesian_deltas, shared_variables_, link_name, avoid_collisions))
+      return;
+  }
+  // If there have not been several consecutive cycles of all zeros and joint
+  // jogging commands are not empty
+  else if ((zero_velocity_count_ <= NUM_ZERO_CYCLES_TO_PUBLISH) && !zero_joint_traj_flag_)
+  {
+    jog_msgs::JogJoint joint_deltas = shared_variables_.joint_command_deltas;
+    anchor_valid_ = false;
+
+    if (!jointJogCalcs(joint_deltas, shared_variables_))
+      return;
+  }
+
+  finishStep();
+}
+
+// True if there is no command to follow and any halt is complete
+bool JogCalcs::isIdle() const
+{
+  // finishStep() stops publishing the cycle after the count passes NUM_ZERO_CYCLES_TO_PUBLISH
+  return !received_first_command_ || zero_velocity_count_ > NUM_ZERO_CYCLES_TO_PUBLISH + 1;
+}
+
+// The robot may be moved by other controllers while jogging is paused.
+// Re-seed the filters and the smoother from its joints when jogging resumes.
+void JogCalcs::enterIdle()
+{
+  joints_initialized_ = false;
+  anchor_valid_ = false;
+}
+
+// Read the joints and the command flags. False if there is nothing to do yet.
+bool JogCalcs::beginStep()
+{
+  jog_arm_shared& shared_variables = shared_variables_;
+
+  // Switch to reloaded parameters between cycles
+  const jog_arm_parameters* shared_parameters = shared_variables.parameters.load(std::memory_order_acquire);
+  if (shared_parameters != shared_parameters_)
+  {
+    applyParameters(*shared_parameters);
+    shared_parameters_ = shared_parameters;
   }
 
   // Initialize the position filters to initial robot joints
-  while (!updateJoints() && ros::ok())
+  if (!joints_initialized_)
   {
-    incoming_jts_ = shared_variables.joints;
-    ros::Duration(0.001).sleep();
+    readIncomingJoints(shared_variables);
+    if (!updateJoints())
+      return false;
+
+    position_filters_->reset(jt_state_.position.data());
+    if (parameters_.smoothing)
+      smoother_->reset(jt_state_.position.data());
+    resetAccelerationEstimate();
+    for (std::size_t i = 0; i < jt_state_.position.size(); ++i)
+      start_posture_[i] = jt_state_.position[i];
+    joints_initialized_ = true;
   }
-  for (std::size_t i = 0; i < jt_state_.name.size(); ++i)
-    position_filters_[i].reset(jt_state_.position[i]);
 
   // Wait for the first jogging cmd.
-  // Store it in a class member for further calcs.
-  // Then free up the shared variable again.
-  geometry_msgs::TwistStamped cartesian_deltas;
-  jog_msgs::JogJoint joint_deltas;
-
-  while (ros::ok() && cartesian_deltas.header.stamp == ros::Time(0.) && joint_deltas.header.stamp == ros::Time(0.))
+  if (!received_first_command_)
   {
-    ros::Duration(0.05).sleep();
+    if (shared_variables.incoming_cmd_stamp == ros::Time(0.))
+      return false;
+    received_first_command_ = true;
+    ROS_INFO_STREAM_NAMED(NODE_NAME, "Ready to jog '" << parameters_.move_group_name << "', "
+                                                      << (ros::WallTime::now() - shared_variables.start_time).toSec()
+                                                      << " s after startup");
+  }
+
+  // If user commands are all zero, reset the low-pass filters
+  // when commands resume
+  zero_cartesian_traj_flag_ = shared_variables.zero_cartesian_cmd_flag;
+  zero_joint_traj_flag_ = shared_variables.zero_joint_cmd_flag;
+
+  if (zero_cartesian_traj_flag_ && zero_joint_traj_flag_)
+    // Reset low-pass filters
+    resetVelocityFilters();
+
+  // Pull data from the shared variables.
+  readIncomingJoints(shared_variables);
+
+  // Try again next cycle if the joint msg is incomplete
+  if (!updateJoints())
+    return false;
+
+  // While stopped, keep the smoother in sync with the robot
+  if (parameters_.smoothing && smoother_->isAtRest())
+    smoother_->reset(jt_state_.position.data());
+
+  return true;
+}
+
+// Switch to reloaded parameters. Filters, smoothing and estimation carry on from their current state.
+void JogCalcs::applyParameters(const jog_arm_parameters& parameters)
+{
+  parameters_ = parameters;
 
-    cartesian_deltas = shared_variables.command_deltas;
-    joint_deltas = shared_variables.joint_command_deltas;
+  velocity_filters_->setSpec(getJointFilterSpec(parameters_));
+  position_filters_->setSpec(getJointFilterSpec(parameters_));
+
+  if (joint_state_estimator_)
+    joint_state_estimator_->setGains(parameters_.joint_state_estimator_alpha, parameters_.joint_state_estimator_beta);
+
+  if (smoother_)
+  {
+    // Joints without an acceleration limit in the robot model use the yaml file's
+    Eigen::VectorXd max_acceleration(acceleration_limits_.size());
+    for (long i = 0; i < acceleration_limits_.size(); ++i)
+      max_acceleration[i] =
+          (acceleration_limits_[i] > 0) ? acceleration_limits_[i] : parameters_.max_joint_acceleration;
+    smoother_->setLimits(max_acceleration,
+                         Eigen::VectorXd::Constant(max_acceleration.size(), parameters_.max_joint_jerk));
   }
+}
 
-  // Track the number of cycles during which motion has not occurred.
-  // Will avoid re-publishing zero velocities endlessly.
-  int zero_velocity_count = 0;
-  int num_zero_cycles_to_publish = 4;
+// Halt if needed, then smooth, limit and share the new trajectory
+void JogCalcs::finishStep()
+{
+  jog_arm_shared& shared_variables = shared_variables_;
 
-  // Now do jogging calcs
-  while (ros::ok())
+  // Halt if the command is stale or inputs are all zero, or commands were
+  // zero
+  if (shared_variables.command_is_stale)
+    raiseStatus(jog_msgs::JogStatus::STALE_COMMAND);
+  if (shared_variables.command_is_stale || (zero_cartesian_traj_flag_ && zero_joint_traj_flag_))
   {
-    // If user commands are all zero, reset the low-pass filters
-    // when commands resume
-    bool zero_cartesian_traj_flag = shared_variables.zero_cartesian_cmd_flag;
-    bool zero_joint_traj_flag = shared_variables.zero_joint_cmd_flag;
+    halt(new_traj_);
+    zero_cartesian_traj_flag_ = true;
+    zero_joint_traj_flag_ = true;
+    anchor_valid_ = false;
+  }
 
-    if (zero_cartesian_traj_flag && zero_joint_traj_flag)
-      // Reset low-pass filters
-      resetVelocityFilters();
+  // Ramp into halts and out of resets
+  if (parameters_.smoothing && !new_traj_.joint_names.empty())
+    smoothOutgoingTrajectory(new_traj_);
 
-    // Pull data from the shared variables.
-    incoming_jts_ = shared_variables.joints;
+  if (!new_traj_.joint_names.empty())
+    applyAccelerationLimits(new_traj_);
 
-    // Initialize the position filters to initial robot joints
-    while (!updateJoints() && ros::ok())
-    {
-      incoming_jts_ = shared_variables.joints;
-      ros::Duration(0.001).sleep();
-    }
+  // Has the velocity command been zero for several cycles in a row?
+  // If so, stop publishing so other controllers can take over
+  bool valid_nonzero_trajectory =
+      !((zero_velocity_count_ > NUM_ZERO_CYCLES_TO_PUBLISH) && zero_cartesian_traj_flag_ && zero_joint_traj_flag_);
 
-    // If there have not been several consecutive cycles of all zeros and joint
-    // jogging commands are empty
-    if ((zero_velocity_count <= num_zero_cycles_to_publish) && zero_joint_traj_flag)
+  // Send the newest target joints
+  if (!new_traj_.joint_names.empty())
+  {
+    // If everything normal, share the new traj to be published
+    if (valid_nonzero_trajectory)
     {
-      cartesian_deltas = shared_variables.command_deltas;
-
-      if (!cartesianJogCalcs(cartesian_deltas, shared_variables))
-        continue;
+      pthread_mutex_lock(&shared_variables.new_traj_mutex);
+      pthread_mutex_lock(&shared_variables.ok_to_publish_mutex);
+      // Copied onto the heap, since the arena is reused by the next cycle
+      shared_variables.new_traj = new_traj_;
+      shared_variables.ok_to_publish = true;
+      pthread_mutex_unlock(&shared_variables.new_traj_mutex);
+      pthread_mutex_unlock(&shared_variables.ok_to_publish_mutex);
     }
-    // If there have not been several consecutive cycles of all zeros and joint
-    // jogging commands are not empty
-    else if ((zero_velocity_count <= num_zero_cycles_to_publish) && !zero_joint_traj_flag)
+    // Skip the jogging publication if all inputs have been zero for several
+    // cycles in a row
+    else if (zero_velocity_count_ > NUM_ZERO_CYCLES_TO_PUBLISH)
     {
-      joint_deltas = shared_variables.joint_command_deltas;
-      ;
+      pthread_mutex_lock(&shared_variables.ok_to_publish_mutex);
+      shared_variables.ok_to_publish = false;
+      pthread_mutex_unlock(&shared_variables.ok_to_publish_mutex);
 
-      if (!jointJogCalcs(joint_deltas, shared_variables))
-        continue;
+      // Other controllers may move the robot before jogging resumes
+      resetAccelerationEstimate();
     }
 
-    // Halt if the command is stale or inputs are all zero, or commands were
-    // zero
-    if (shared_variables.command_is_stale || (zero_cartesian_traj_flag && zero_joint_traj_flag))
+    // The robot should follow this, before joint_states shows it
+    if (parameters_.estimate_joint_states)
+      joint_state_estimator_->setCommandedVelocity(prev_outgoing_velocities_);
+
+    // Store last zero-velocity message flag to prevent superfluous warnings.
+    // Cartesian and joint commands must both be zero, and any halt must be complete.
+    if (zero_cartesian_traj_flag_ && zero_joint_traj_flag_ && (!parameters_.smoothing || smoother_->isAtRest()))
+      zero_velocity_count_ += 1;
+    else
+      zero_velocity_count_ = 0;
+  }
+
+  publishStatus();
+}
+
+// Perform the jogging calculations
+bool JogCalcs::cartesianJogCalcs(const geometry_msgs::TwistStamped& cmd, jog_arm_shared& shared_variables,
+                                 const std::string& link_name, const bool avoid_collisions)
+{
+  if (!isValidCartesianCommand(cmd))
+    return 0;
+
+  kinematic_state_->setVariableValues(jt_state_);
+
+  geometry_msgs::TwistStamped twist_cmd;
+  if (!transformToPlanningFrame(cmd, twist_cmd))
+    return 0;
+
+  const Eigen::VectorXd delta_x = scaleCartesianCommand(twist_cmd);
+
+  return cartesianDeltaJogCalcs(delta_x, shared_variables, link_name, avoid_collisions, parameters_.correct_drift);
+}
+
+// Joint increments that move the link back onto anchor_pose_, across the commanded direction
+Eigen::VectorXd JogCalcs::getDriftCorrection(const Eigen::VectorXd& delta_x, const LinkJacobian& link_jacobian,
+                                             const Eigen::MatrixXd& pseudo_inverse)
+{
+  const Eigen::Isometry3d& link_pose = kinematic_state_->getGlobalLinkTransform(link_jacobian.link);
+  const ros::WallTime now = ros::WallTime::now();
+  if (!anchor_valid_ || anchor_link_ != link_jacobian.link->getName())
+  {
+    anchor_pose_ = link_pose;
+    anchor_link_ = link_jacobian.link->getName();
+    anchor_valid_ = true;
+    last_ik_anchor_time_ = now;
+    return Eigen::VectorXd::Zero(pseudo_inverse.rows());
+  }
+
+  // Along the commanded direction, the error is mostly the robot lagging behind the command.
+  // Correcting it would only inflate the velocity, so slide the anchor to the robot instead.
+  Eigen::VectorXd error = getPoseError(anchor_pose_, link_pose);
+  Eigen::VectorXd lag(6);
+  lag.head<3>() = projectOnto(error.head<3>(), delta_x.head<3>());
+  lag.tail<3>() = projectOnto(error.tail<3>(), delta_x.tail<3>());
+  displacePose(anchor_pose_, -lag);
+  error -= lag;
+
+  // Now and then, solve the full IK for the anchor. A Newton step only sees the local linearization.
+  // A solution that jumps, e.g. to another configuration, is not used.
+  if (ik_available_ && parameters_.drift_correction_ik_period > 0. &&
+      (now - last_ik_anchor_time_).toSec() >= parameters_.drift_correction_ik_period)
+  {
+    last_ik_anchor_time_ = now;
+
+    std::vector<double> seed, solution;
+    kinematic_state_->copyJointGroupPositions(joint_model_group_, seed);
+    const bool solved = kinematic_state_->setFromIK(joint_model_group_, anchor_pose_, anchor_link_,
+                                                    parameters_.drift_correction_ik_timeout);
+    kinematic_state_->copyJointGroupPositions(joint_model_group_, solution);
+    kinematic_state_->setJointGroupPositions(joint_model_group_, seed);
+
+    if (solved && solution.size() == seed.size())
     {
-      halt(new_traj_);
-      zero_cartesian_traj_flag = true;
-      zero_joint_traj_flag = true;
+      Eigen::VectorXd correction(seed.size());
+      for (std::size_t i = 0; i < seed.size(); ++i)
+        correction[i] = solution[i] - seed[i];
+      if (correction.cwiseAbs().maxCoeff() <= parameters_.joint_scale)
+        return parameters_.drift_correction_gain * correction;
     }
+  }
 
-    // Has the velocity command been zero for several cycles in a row?
-    // If so, stop publishing so other controllers can take over
-    bool valid_nonzero_trajectory =
-        !((zero_velocity_count > num_zero_cycles_to_publish) && zero_cartesian_traj_flag && zero_joint_traj_flag);
+  // One Newton step, with the Jacobian of this cycle
+  return parameters_.drift_correction_gain * (pseudo_inverse * error);
+}
 
-    // Send the newest target joints
-    if (!new_traj_.joint_names.empty())
-    {
-      // If everything normal, share the new traj to be published
-      if (valid_nonzero_trajectory)
-      {
-        pthread_mutex_lock(&shared_variables.new_traj_mutex);
-        pthread_mutex_lock(&shared_variables.ok_to_publish_mutex);
-        shared_variables.new_traj = new_traj_;
-        shared_variables.ok_to_publish = true;
-        pthread_mutex_unlock(&shared_variables.new_traj_mutex);
-        pthread_mutex_unlock(&shared_variables.ok_to_publish_mutex);
-      }
-      // Skip the jogging publication if all inputs have been zero for several
-      // cycles in a row
-      else if (zero_velocity_count > num_zero_cycles_to_publish)
-      {
-        pthread_mutex_lock(&shared_variables.ok_to_publish_mutex);
-        shared_variables.ok_to_publish = false;
-        pthread_mutex_unlock(&shared_variables.ok_to_publish_mutex);
-      }
+// Joint increments toward the null_space objectives, projected through I - V*V^T so they don't move the link
+Eigen::VectorXd JogCalcs::getNullSpaceMotion(const Eigen::MatrixXd& matrix_v, const Eigen::VectorXd& singular_values,
+                                             const LinkJacobian& link_jacobian)
+{
+  const long num_joints = matrix_v.rows();
+  Eigen::VectorXd gradient = Eigen::VectorXd::Zero(num_joints);
 
-      // Store last zero-velocity message flag to prevent superfluous warnings.
-      // Cartesian and joint commands must both be zero.
-      if (zero_cartesian_traj_flag && zero_joint_traj_flag)
-        zero_velocity_count += 1;
-      else
-        zero_velocity_count = 0;
+  // No spare joints, or nothing to do with them
+  if (num_joints <= matrix_v.cols() ||
+      (parameters_.null_space_joint_limit_gain <= 0. && parameters_.null_space_manipulability_gain <= 0. &&
+       parameters_.null_space_posture_gain <= 0.))
+    return gradient;
+
+  const Eigen::Map<const Eigen::VectorXd> positions(jt_state_.position.data(), num_joints);
+
+  // Toward the middle of each joint's range, at joint_limit_gain for a joint at its limit
+  if (parameters_.null_space_joint_limit_gain > 0.)
+  {
+    for (long i = 0; i < num_joints; ++i)
+    {
+      if (joint_half_ranges_[i] > 0.)
+        gradient[i] -= parameters_.null_space_joint_limit_gain * (positions[i] - joint_mid_positions_[i]) /
+                       joint_half_ranges_[i];
     }
+  }
+
+  if (parameters_.null_space_manipulability_gain > 0.)
+    gradient += parameters_.null_space_manipulability_gain * getManipulabilityGradient(singular_values, link_jacobian);
 
-    // Add a small sleep to avoid 100% CPU usage
-    ros::Duration(0.005).sleep();
+  // Back toward a posture
+  if (parameters_.null_space_posture_gain > 0.)
+  {
+    if (parameters_.null_space_posture.empty())
+      gradient -= parameters_.null_space_posture_gain * (positions - start_posture_);
+    else if (parameters_.null_space_posture.size() == static_cast<std::size_t>(num_joints))
+      gradient -= parameters_.null_space_posture_gain *
+                  (positions - Eigen::Map<const Eigen::VectorXd>(parameters_.null_space_posture.data(), num_joints));
+    else
+      JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(10, NODE_NAME,
+                                        "Parameter 'null_space/posture' needs one position per joint of '%s'. "
+                                        "Check yaml file.",
+                                        parameters_.move_group_name.c_str());
   }
+
+  // The gains are velocities. Keep only the part that doesn't move the link.
+  gradient *= parameters_.publish_period;
+  return gradient - matrix_v * (matrix_v.transpose() * gradient);
 }
 
-// Perform the jogging calculations
-bool JogCalcs::cartesianJogCalcs(const geometry_msgs::TwistStamped& cmd, jog_arm_shared& shared_variables)
+// Gradient of the log of the link's manipulability, the product of the Jacobian's singular values
+Eigen::VectorXd JogCalcs::getManipulabilityGradient(const Eigen::VectorXd& singular_values,
+                                                    const LinkJacobian& link_jacobian)
+{
+  const double log_manipulability = singular_values.array().max(1e-12).log().sum();
+
+  std::vector<double> positions;
+  kinematic_state_->copyJointGroupPositions(joint_model_group_, positions);
+  Eigen::VectorXd gradient(positions.size());
+  Eigen::MatrixXd jacobian;
+  for (std::size_t i = 0; i < positions.size(); ++i)
+  {
+    positions[i] += MANIPULABILITY_GRADIENT_STEP;
+    kinematic_state_->setJointGroupPositions(joint_model_group_, positions);
+    kinematic_state_->getJacobian(joint_model_group_, link_jacobian.link, Eigen::Vector3d::Zero(), jacobian);
+    const Eigen::VectorXd perturbed_singular_values = Eigen::JacobiSVD<Eigen::MatrixXd>(jacobian).singularValues();
+    gradient[i] =
+        (perturbed_singular_values.array().max(1e-12).log().sum() - log_manipulability) / MANIPULABILITY_GRADIENT_STEP;
+    positions[i] -= MANIPULABILITY_GRADIENT_STEP;
+  }
+  kinematic_state_->setJointGroupPositions(joint_model_group_, positions);
+
+  if (!gradient.allFinite())
+    return Eigen::VectorXd::Zero(positions.size());
+  return gradient;
+}
+
+// Move the tip toward a target pose
+bool JogCalcs::poseTrackingJogCalcs(const geometry_msgs::PoseStamped& cmd, jog_arm_shared& shared_variables)
+{
+  const Eigen::Vector3d target_position(cmd.pose.position.x, cmd.pose.position.y, cmd.pose.position.z);
+  Eigen::Quaterniond target_orientation(cmd.pose.orientation.w, cmd.pose.orientation.x, cmd.pose.orientation.y,
+                                        cmd.pose.orientation.z);
+  if (!target_position.allFinite() || !target_orientation.coeffs().allFinite() ||
+      target_orientation.norm() < 1e-6)
+  {
+    JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(2, NODE_NAME,
+                                      "nan or invalid orientation in target pose. Skipping this datapoint.");
+    return 0;
+  }
+  target_orientation.normalize();
+
+  // Forward kinematics at the joints of this cycle
+  kinematic_state_->setVariableValues(jt_state_);
+
+  Eigen::Isometry3d target = Eigen::Isometry3d::Identity();
+  target.linear() = target_orientation.toRotationMatrix();
+  target.translation() = target_position;
+  Eigen::Isometry3d transform;
+  if (!getReferenceTransform(cmd.header.frame_id, transform))
+    return 0;
+  target = transform * target;
+
+  const Eigen::Isometry3d& tip = kinematic_state_->getGlobalLinkTransform(joint_model_group_->getLinkModels().back());
+
+  // Proportional control, capped to the maximum velocities
+  const Eigen::VectorXd error = getPoseError(target, tip);
+  Eigen::Vector3d linear_velocity = parameters_.pose_linear_gain * error.head<3>();
+  Eigen::Vector3d angular_velocity = parameters_.pose_angular_gain * error.tail<3>();
+  if (linear_velocity.norm() > parameters_.pose_max_linear_velocity)
+    linear_velocity *= parameters_.pose_max_linear_velocity / linear_velocity.norm();
+  if (angular_velocity.norm() > parameters_.pose_max_angular_velocity)
+    angular_velocity *= parameters_.pose_max_angular_velocity / angular_velocity.norm();
+
+  Eigen::VectorXd delta_x(6);
+  delta_x.head<3>() = linear_velocity * parameters_.publish_period;
+  delta_x.tail<3>() = angular_velocity * parameters_.publish_period;
+
+  // The target already closes the loop, so there is no drift to correct
+  return cartesianDeltaJogCalcs(delta_x, shared_variables, "", true, false);
+}
+
+// Convert a displacement of a link in the planning frame to joint increments.
+// Needs kinematic_state_ at the current joints.
+bool JogCalcs::cartesianDeltaJogCalcs(const Eigen::VectorXd& delta_x, jog_arm_shared& shared_variables,
+                                      const std::string& link_name, const bool avoid_collisions,
+                                      const bool correct_drift)
+{
+  // Convert from cartesian commands to joint commands
+  const LinkJacobian* link_jacobian = getLinkJacobian(link_name);
+  if (!link_jacobian)
+    return 0;
+  const Eigen::MatrixXd& jacobian = link_jacobian->jacobian;
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd(jacobian, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  const Eigen::MatrixXd pseudo_inverse =
+      pseudoInverse(svd.matrixU(), svd.matrixV(), svd.singularValues().asDiagonal());
+  Eigen::VectorXd delta_theta = pseudo_inverse * delta_x;
+
+  if (correct_drift)
+    delta_theta += getDriftCorrection(delta_x, *link_jacobian, pseudo_inverse);
+  else
+    anchor_valid_ = false;
+
+  // A redundant arm can use its spare joints to stay away from limits and singularities
+  delta_theta += getNullSpaceMotion(svd.matrixV(), svd.singularValues(), *link_jacobian);
+
+  const double joint_velocity_scale = enforceJointVelocityLimits(delta_theta);
+
+  // If close to a collision or a singularity, decelerate
+  if (avoid_collisions)
+    raiseCollisionStatus();
+  const double velocity_scale = decelerateForSingularity(jacobian, delta_x, link_jacobian->link) *
+                                (avoid_collisions ? shared_variables.collision_velocity_scale : 1.);
+
+  if (!applyJointIncrements(delta_theta, velocity_scale))
+    return 0;
+
+  // The anchor moves as far as the link was commanded to
+  if (anchor_valid_)
+    displacePose(anchor_pose_, delta_x * (joint_velocity_scale * velocity_scale));
+
+  if (!checkIfJointsWithinBounds(new_traj_))
+  {
+    halt(new_traj_);
+    publishWarning(true);
+    anchor_valid_ = false;
+  }
+  else
+    publishWarning(false);
+
+  // If using Gazebo simulator, insert redundant points
+  if (parameters_.gazebo)
+  {
+    insertRedundantPointsIntoTrajectory(new_traj_, GAZEBO_REDUNTANT_MESSAGE_COUNT);
+  }
+
+  return 1;
+}
+
+// Check for nan's and, for unitless commands, components beyond [-1:1]
+bool JogCalcs::isValidCartesianCommand(const geometry_msgs::TwistStamped& cmd) const
 {
   // Check for nan's in the incoming command
   if (std::isnan(cmd.twist.linear.x) || std::isnan(cmd.twist.linear.y) || std::isnan(cmd.twist.linear.z) ||
       std::isnan(cmd.twist.angular.x) || std::isnan(cmd.twist.angular.y) || std::isnan(cmd.twist.angular.z))
   {
-    ROS_WARN_STREAM_NAMED(NODE_NAME, "nan in incoming command. Skipping this datapoint.");
+    JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(1, NODE_NAME, "nan in incoming command. Skipping this datapoint.");
     return 0;
   }
 
@@ -483,68 +1722,138 @@ bool JogCalcs::cartesianJogCalcs(const geometry_msgs::TwistStamped& cmd, jog_arm
     if ((fabs(cmd.twist.linear.x) > 1) || (fabs(cmd.twist.linear.y) > 1) || (fabs(cmd.twist.linear.z) > 1) ||
         (fabs(cmd.twist.angular.x) > 1) || (fabs(cmd.twist.angular.y) > 1) || (fabs(cmd.twist.angular.z) > 1))
     {
-      ROS_WARN_STREAM_NAMED(NODE_NAME, "Component of incoming command is >1. Skipping this datapoint.");
+      JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(1, NODE_NAME, "Component of incoming command is >1. Skipping this datapoint.");
       return 0;
     }
   }
 
+  return 1;
+}
+
+bool JogCalcs::transformToPlanningFrame(const geometry_msgs::TwistStamped& cmd,
+                                        geometry_msgs::TwistStamped& twist_cmd)
+{
   // Convert the cmd to the MoveGroup planning frame.
-  try
-  {
-    listener_.waitForTransform(cmd.header.frame_id, parameters_.planning_frame, ros::Time::now(), ros::Duration(0.2));
-  }
-  catch (const tf::TransformException& ex)
-  {
-    ROS_ERROR_STREAM_NAMED(NODE_NAME, ros::this_node::getName() << ": " << ex.what());
+  Eigen::Isometry3d transform;
+  if (!getReferenceTransform(cmd.header.frame_id, transform))
     return 0;
-  }
-  // To transform, these vectors need to be stamped. See answers.ros.org
-  // Q#199376
-  // Transform the linear component of the cmd message
-  geometry_msgs::Vector3Stamped lin_vector;
-  lin_vector.vector = cmd.twist.linear;
-  lin_vector.header.frame_id = cmd.header.frame_id;
-  try
+  const Eigen::Matrix3d rotation = transform.rotation();
+
+  const Eigen::Vector3d linear = rotation * Eigen::Vector3d(cmd.twist.linear.x, cmd.twist.linear.y, cmd.twist.linear.z);
+  const Eigen::Vector3d angular =
+      rotation * Eigen::Vector3d(cmd.twist.angular.x, cmd.twist.angular.y, cmd.twist.angular.z);
+
+  // Put these components back into a TwistStamped
+  twist_cmd.header.stamp = cmd.header.stamp;
+  twist_cmd.header.frame_id = parameters_.planning_frame;
+  twist_cmd.twist.linear.x = linear[0];
+  twist_cmd.twist.linear.y = linear[1];
+  twist_cmd.twist.linear.z = linear[2];
+  twist_cmd.twist.angular.x = angular[0];
+  twist_cmd.twist.angular.y = angular[1];
+  twist_cmd.twist.angular.z = angular[2];
+
+  return 1;
+}
+
+// Transform from a frame to the planning frame
+bool JogCalcs::getReferenceTransform(const std::string& frame_id, Eigen::Isometry3d& transform)
+{
+  if (!joint_model_group_->isLinkUpdated(frame_id))
+    return lookupReferenceTransform(frame_id, transform);
+
+  // A tool or camera frame moves with the joints. Take it from the joints of this cycle,
+  // relative to the move group's base, so it doesn't lag behind TF.
+  if (!lookupReferenceTransform(group_base_frame_, transform))
+    return 0;
+  transform = transform * kinematic_state_->getGlobalLinkTransform(group_base_frame_).inverse() *
+              kinematic_state_->getGlobalLinkTransform(frame_id);
+  return 1;
+}
+
+// Transform of a frame off the move group, from TF. Cached per frame ID.
+bool JogCalcs::lookupReferenceTransform(const std::string& frame_id, Eigen::Isometry3d& transform)
+{
+  if (frame_id == parameters_.planning_frame)
   {
-    listener_.transformVector(parameters_.planning_frame, lin_vector, lin_vector);
+    transform.setIdentity();
+    return 1;
   }
-  catch (const tf::TransformException& ex)
+
+  const ros::WallTime now = ros::WallTime::now();
+  std::map<std::string, ReferenceTransform>::iterator cached = reference_transforms_.find(frame_id);
+  if (cached != reference_transforms_.end() &&
+      now - cached->second.lookup_time < ros::WallDuration(REFERENCE_FRAME_CACHE_PERIOD))
   {
-    ROS_ERROR_STREAM_NAMED(NODE_NAME, ros::this_node::getName() << ": " << ex.what());
-    return 0;
+    transform = cached->second.transform;
+    return 1;
   }
 
-  geometry_msgs::Vector3Stamped rot_vector;
-  rot_vector.vector = cmd.twist.angular;
-  rot_vector.header.frame_id = cmd.header.frame_id;
+  tf::StampedTransform tf_transform;
   try
   {
-    listener_.transformVector(parameters_.planning_frame, rot_vector, rot_vector);
+    // Only wait for a frame that was never found
+    if (cached == reference_transforms_.end())
+      listener_.waitForTransform(parameters_.planning_frame, frame_id, ros::Time(0), ros::Duration(0.2));
+    listener_.lookupTransform(parameters_.planning_frame, frame_id, ros::Time(0), tf_transform);
   }
   catch (const tf::TransformException& ex)
   {
-    ROS_ERROR_STREAM_NAMED(NODE_NAME, ros::this_node::getName() << ": " << ex.what());
+    JOG_ARM_ASYNC_ERROR_THROTTLE_NAMED(1, NODE_NAME, "%s", ex.what());
     return 0;
   }
 
-  // Put these components back into a TwistStamped
-  geometry_msgs::TwistStamped twist_cmd;
-  twist_cmd.header.stamp = cmd.header.stamp;
-  twist_cmd.header.frame_id = parameters_.planning_frame;
-  twist_cmd.twist.linear = lin_vector.vector;
-  twist_cmd.twist.angular = rot_vector.vector;
+  const tf::Quaternion q = tf_transform.getRotation();
+  const tf::Vector3 origin = tf_transform.getOrigin();
+  ReferenceTransform& reference_transform = reference_transforms_[frame_id];
+  reference_transform.transform.setIdentity();
+  reference_transform.transform.linear() = Eigen::Quaterniond(q.w(), q.x(), q.y(), q.z()).toRotationMatrix();
+  reference_transform.transform.translation() = Eigen::Vector3d(origin.x(), origin.y(), origin.z());
+  reference_transform.lookup_time = now;
+  transform = reference_transform.transform;
+  return 1;
+}
 
-  const Eigen::VectorXd delta_x = scaleCartesianCommand(twist_cmd);
+// The Jacobian of a link that the move group moves, or of its tip
+const JogCalcs::LinkJacobian* JogCalcs::getLinkJacobian(const std::string& link_name)
+{
+  std::map<std::string, LinkJacobian>::iterator cached = link_jacobians_.find(link_name);
+  if (cached == link_jacobians_.end())
+  {
+    const robot_model::LinkModel* link = nullptr;
+    if (link_name.empty())
+      link = joint_model_group_->getLinkModels().back();
+    else if (joint_model_group_->isLinkUpdated(link_name))
+      link = kinematic_state_->getRobotModel()->getLinkModel(link_name);
+    if (!link)
+    {
+      JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(2, NODE_NAME,
+                                        "Move group '%s' does not move link '%s'. Skipping this datapoint.",
+                                        parameters_.move_group_name.c_str(), link_name.c_str());
+      return nullptr;
+    }
 
-  kinematic_state_->setVariableValues(jt_state_);
-  original_jts_ = jt_state_;
+    cached = link_jacobians_.insert(std::make_pair(link_name, LinkJacobian())).first;
+    cached->second.link = link;
+  }
 
-  // Convert from cartesian commands to joint commands
-  Eigen::MatrixXd jacobian = kinematic_state_->getJacobian(joint_model_group_);
-  Eigen::JacobiSVD<Eigen::MatrixXd> svd(jacobian, Eigen::ComputeThinU | Eigen::ComputeThinV);
-  Eigen::VectorXd delta_theta = pseudoInverse(svd.matrixU(), svd.matrixV(), svd.singularValues().asDiagonal()) * delta_x;
+  // The Jacobian only changes when the joints move, e.g. not while halted at a joint limit
+  LinkJacobian& link_jacobian = cached->second;
+  if (link_jacobian.positions != jt_state_.position || link_jacobian.jacobian.size() == 0)
+  {
+    kinematic_state_->getJacobian(joint_model_group_, link_jacobian.link, Eigen::Vector3d::Zero(),
+                                  link_jacobian.jacobian);
+    link_jacobian.positions = jt_state_.position;
+  }
+  return &link_jacobian;
+}
+
+// Add joint increments, filter them and compose new_traj_.
+// velocity_scale slows down near singularities and collisions.
+bool JogCalcs::applyJointIncrements(const Eigen::VectorXd& delta_theta, const double velocity_scale)
+{
+  original_jts_ = jt_state_;
 
-  enforceJointVelocityLimits(delta_theta);
   if (!addJointIncrements(jt_state_, delta_theta))
     return 0;
 
@@ -557,22 +1866,7 @@ bool JogCalcs::cartesianJogCalcs(const geometry_msgs::TwistStamped& cmd, jog_arm
   const ros::Time next_time = ros::Time::now() + ros::Duration(parameters_.publish_period);
   new_traj_ = composeOutgoingMessage(jt_state_, next_time);
 
-  // If close to a collision or a singularity, decelerate
-  applyVelocityScaling(shared_variables, new_traj_, delta_theta, decelerateForSingularity(jacobian, delta_x));
-
-  if (!checkIfJointsWithinBounds(new_traj_))
-  {
-    halt(new_traj_);
-    publishWarning(true);
-  }
-  else
-    publishWarning(false);
-
-  // If using Gazebo simulator, insert redundant points
-  if (parameters_.gazebo)
-  {
-    insertRedundantPointsIntoTrajectory(new_traj_, GAZEBO_REDUNTANT_MESSAGE_COUNT);
-  }
+  applyVelocityScaling(new_traj_, delta_theta, velocity_scale);
 
   return 1;
 }
@@ -584,7 +1878,7 @@ bool JogCalcs::jointJogCalcs(const jog_msgs::JogJoint& cmd, jog_arm_shared& shar
   {
     if (std::isnan(cmd.deltas[i]) || (fabs(cmd.deltas[i]) > 1))
     {
-      ROS_WARN_STREAM_NAMED(NODE_NAME, "nan in incoming command. Skipping this datapoint.");
+      JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(1, NODE_NAME, "nan in incoming command. Skipping this datapoint.");
       return 0;
     }
   }
@@ -636,24 +1930,125 @@ bool JogCalcs::jointJogCalcs(const jog_msgs::JogJoint& cmd, jog_arm_shared& shar
 // simulation.
 // Start from 2 because the first point's timestamp is already
 // 1*parameters_.publish_period
-void JogCalcs::insertRedundantPointsIntoTrajectory(trajectory_msgs::JointTrajectory& trajectory, int count) const
+void JogCalcs::insertRedundantPointsIntoTrajectory(JogTrajectory& trajectory, int count) const
 {
-  auto point = trajectory.points[0];
   // Start from 2 because we already have the first point. End at count+1 so
-  // total # == count
+  // total # == count. Each point is assigned, not copied, so it stays in the trajectory's arena.
+  const ArenaAllocator<void> allocator(trajectory.points.get_allocator());
   for (int i = 2; i < count + 1; ++i)
   {
-    point.time_from_start = ros::Duration(i * parameters_.publish_period);
-    trajectory.points.push_back(point);
+    trajectory.points.emplace_back(allocator);
+    trajectory.points.back() = trajectory.points[0];
+    trajectory.points.back().time_from_start = ros::Duration(i * parameters_.publish_period);
+  }
+}
+
+// Velocity-controlled robots track the calculated velocity.
+// Position-controlled robots head for the calculated position.
+void JogCalcs::smoothOutgoingTrajectory(JogTrajectory& jt_traj)
+{
+  Eigen::VectorXd target_velocity(jt_state_.name.size());
+  for (std::size_t i = 0; i < jt_state_.name.size(); ++i)
+  {
+    if (parameters_.publish_joint_velocities)
+      target_velocity[i] = jt_traj.points[0].velocities[i];
+    else
+      target_velocity[i] = (jt_traj.points[0].positions[i] - smoother_->position()[i]) / parameters_.publish_period;
+  }
+
+  smoother_->update(target_velocity);
+
+  // Gazebo trajectories hold several copies of the same point
+  for (auto& point : jt_traj.points)
+  {
+    for (std::size_t i = 0; i < jt_state_.name.size(); ++i)
+    {
+      if (parameters_.publish_joint_positions)
+        point.positions[i] = smoother_->position()[i];
+      if (parameters_.publish_joint_velocities)
+        point.velocities[i] = smoother_->velocity()[i];
+    }
+  }
+}
+
+void JogCalcs::applyAccelerationLimits(JogTrajectory& jt_traj)
+{
+  const std::size_t num_joints = jt_state_.name.size();
+  JogTrajectoryPoint& point = jt_traj.points[0];
+
+  // Position-controlled robots may not publish velocities. Then, difference the positions.
+  Eigen::VectorXd velocity(num_joints);
+  for (std::size_t i = 0; i < num_joints; ++i)
+  {
+    if (parameters_.publish_joint_velocities)
+      velocity[i] = point.velocities[i];
+    else
+      velocity[i] = (point.positions[i] - prev_outgoing_positions_[i]) / parameters_.publish_period;
+  }
+
+  Eigen::VectorXd delta_velocity = velocity - prev_outgoing_velocities_;
+
+  // Scale the change of the entire joint velocity vector, so the direction of motion is kept
+  if (parameters_.enforce_acceleration_limits)
+  {
+    double scale = 1;
+    for (std::size_t i = 0; i < num_joints; ++i)
+    {
+      const double acceleration = fabs(delta_velocity[i]) / parameters_.publish_period;
+      if (acceleration_limits_[i] > 0 && acceleration > acceleration_limits_[i])
+        scale = std::min(scale, acceleration_limits_[i] / acceleration);
+    }
+
+    if (scale < 1)
+    {
+      delta_velocity *= scale;
+      const Eigen::VectorXd limited_velocity = prev_outgoing_velocities_ + delta_velocity;
+      for (auto& redundant_point : jt_traj.points)
+      {
+        for (std::size_t i = 0; i < num_joints; ++i)
+        {
+          if (parameters_.publish_joint_positions)
+          {
+            if (parameters_.publish_joint_velocities)
+              redundant_point.positions[i] += (limited_velocity[i] - velocity[i]) * parameters_.publish_period;
+            else
+              redundant_point.positions[i] =
+                  prev_outgoing_positions_[i] + limited_velocity[i] * parameters_.publish_period;
+          }
+          if (parameters_.publish_joint_velocities)
+            redundant_point.velocities[i] = limited_velocity[i];
+        }
+      }
+      velocity = limited_velocity;
+    }
+  }
+
+  if (parameters_.publish_joint_accelerations)
+  {
+    for (auto& redundant_point : jt_traj.points)
+      for (std::size_t i = 0; i < num_joints; ++i)
+        redundant_point.accelerations[i] = delta_velocity[i] / parameters_.publish_period;
   }
+
+  prev_outgoing_velocities_ = velocity;
+  if (parameters_.publish_joint_positions)
+    prev_outgoing_positions_ = Eigen::Map<const Eigen::VectorXd>(point.positions.data(), num_joints);
+  else
+    prev_outgoing_positions_ += velocity * parameters_.publish_period;
+}
+
+void JogCalcs::resetAccelerationEstimate()
+{
+  prev_outgoing_positions_ = Eigen::Map<const Eigen::VectorXd>(jt_state_.position.data(), jt_state_.position.size());
+  prev_outgoing_velocities_ = Eigen::VectorXd::Zero(jt_state_.position.size());
 }
 
 void JogCalcs::lowPassFilterPositions()
 {
+  position_filters_->filter(jt_state_.position.data());
+
   for (size_t i = 0; i < jt_state_.name.size(); ++i)
   {
-    jt_state_.position[i] = position_filters_[i].filter(jt_state_.position[i]);
-
     // Check for nan's
     if (std::isnan(jt_state_.position[i]))
     {
@@ -665,43 +2060,50 @@ void JogCalcs::lowPassFilterPositions()
 
 void JogCalcs::lowPassFilterVelocities(const Eigen::VectorXd& joint_vel)
 {
+  Eigen::Map<Eigen::ArrayXd> filtered_vel(jt_state_.velocity.data(), static_cast<long>(jt_state_.velocity.size()));
+  velocity_filters_->filter(joint_vel.array(), filtered_vel);
+
   for (size_t i = 0; i < jt_state_.name.size(); ++i)
   {
-    jt_state_.velocity[i] = velocity_filters_[i].filter(joint_vel[static_cast<long>(i)]);
-
     // Check for nan's
     if (std::isnan(jt_state_.velocity[static_cast<long>(i)]))
     {
       jt_state_.position[i] = original_jts_.position[i];
       jt_state_.velocity[i] = 0.;
-      ROS_WARN_STREAM_NAMED(NODE_NAME, "nan in velocity filter");
+      JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(1, NODE_NAME, "nan in velocity filter");
     }
   }
 }
 
-trajectory_msgs::JointTrajectory JogCalcs::composeOutgoingMessage(sensor_msgs::JointState& joint_state,
-                                                                  const ros::Time& stamp) const
+JogTrajectory JogCalcs::composeOutgoingMessage(sensor_msgs::JointState& joint_state, const ros::Time& stamp)
 {
-  trajectory_msgs::JointTrajectory new_jt_traj;
-  new_jt_traj.header.frame_id = parameters_.planning_frame;
+  // Swap arenas. new_traj_ stays valid until this message replaces it.
+  ArenaAllocator<void> allocator;
+  if (parameters_.use_arena_allocator)
+  {
+    message_arena_index_ = 1 - message_arena_index_;
+    message_arenas_[message_arena_index_].reset();
+    allocator = ArenaAllocator<void>(&message_arenas_[message_arena_index_]);
+  }
+
+  JogTrajectory new_jt_traj(allocator);
+  new_jt_traj.header.frame_id.assign(parameters_.planning_frame.begin(), parameters_.planning_frame.end());
   new_jt_traj.header.stamp = stamp;
-  new_jt_traj.joint_names = joint_state.name;
+  new_jt_traj.joint_names.reserve(joint_state.name.size());
+  for (const std::string& name : joint_state.name)
+    new_jt_traj.joint_names.emplace_back(name.begin(), name.end(), allocator);
 
-  trajectory_msgs::JointTrajectoryPoint point;
+  new_jt_traj.points.reserve(parameters_.gazebo ? GAZEBO_REDUNTANT_MESSAGE_COUNT : 1);
+  new_jt_traj.points.emplace_back(allocator);
+  JogTrajectoryPoint& point = new_jt_traj.points.back();
   point.time_from_start = ros::Duration(parameters_.publish_period);
   if (parameters_.publish_joint_positions)
-    point.positions = joint_state.position;
+    point.positions.assign(joint_state.position.begin(), joint_state.position.end());
   if (parameters_.publish_joint_velocities)
-    point.velocities = joint_state.velocity;
+    point.velocities.assign(joint_state.velocity.begin(), joint_state.velocity.end());
+  // Filled in by applyAccelerationLimits()
   if (parameters_.publish_joint_accelerations)
-  {
-    // I do not know of a robot that takes acceleration commands.
-    // However, some controllers check that this data is non-empty.
-    // Send all zeros, for now.
-    std::vector<double> acceleration(joint_state.velocity.size());
-    point.accelerations = acceleration;
-  }
-  new_jt_traj.points.push_back(point);
+    point.accelerations.resize(joint_state.velocity.size());
 
   return new_jt_traj;
 }
@@ -710,11 +2112,9 @@ trajectory_msgs::JointTrajectory JogCalcs::composeOutgoingMessage(sensor_msgs::J
 // Scale for collisions is read from a shared variable.
 // Key equation: new_velocity =
 // collision_scale*singularity_scale*previous_velocity
-bool JogCalcs::applyVelocityScaling(jog_arm_shared& shared_variables, trajectory_msgs::JointTrajectory& new_jt_traj,
-                                    const Eigen::VectorXd& delta_theta, double singularity_scale)
+bool JogCalcs::applyVelocityScaling(JogTrajectory& new_jt_traj, const Eigen::VectorXd& delta_theta,
+                                    double velocity_scale)
 {
-  double collision_scale = shared_variables.collision_velocity_scale;
-
   for (size_t i = 0; i < jt_state_.velocity.size(); ++i)
   {
     if (parameters_.publish_joint_positions)
@@ -723,29 +2123,32 @@ bool JogCalcs::applyVelocityScaling(jog_arm_shared& shared_variables, trajectory
       // angles
       new_jt_traj.points[0].positions[i] =
           new_jt_traj.points[0].positions[i] -
-          (1. - singularity_scale * collision_scale) * delta_theta[static_cast<long>(i)];
+          (1. - velocity_scale) * delta_theta[static_cast<long>(i)];
     }
     if (parameters_.publish_joint_velocities)
-      new_jt_traj.points[0].velocities[i] *= singularity_scale * collision_scale;
+      new_jt_traj.points[0].velocities[i] *= velocity_scale;
   }
 
   return 1;
 }
 
 
-void JogCalcs::enforceJointVelocityLimits(Eigen::VectorXd& calculated_joint_vel)
+double JogCalcs::enforceJointVelocityLimits(Eigen::VectorXd& calculated_joint_vel)
 {
   double maximum_joint_vel = calculated_joint_vel.cwiseAbs().maxCoeff();
   if(maximum_joint_vel > parameters_.joint_scale)
   {
     // Scale the entire joint velocity vector so that each joint velocity is below min, and the output movement is scaled uniformly to match expected motion
     calculated_joint_vel = calculated_joint_vel * parameters_.joint_scale / maximum_joint_vel;
+    return parameters_.joint_scale / maximum_joint_vel;
   }
+  return 1.;
 }
 
 // Possibly calculate a velocity scaling factor, due to proximity of singularity
 // and direction of motion
-double JogCalcs::decelerateForSingularity(Eigen::MatrixXd jacobian, const Eigen::VectorXd commanded_velocity)
+double JogCalcs::decelerateForSingularity(Eigen::MatrixXd jacobian, const Eigen::VectorXd commanded_velocity,
+                                          const robot_model::LinkModel* link)
 {
   double velocity_scale = 1;
 
@@ -775,13 +2178,16 @@ double JogCalcs::decelerateForSingularity(Eigen::MatrixXd jacobian, const Eigen:
   // Calculate a small change in joints
   Eigen::VectorXd delta_theta = pseudoInverse(jacobian) * delta_x;
 
-  double theta[6];
-  const double* prev_joints = kinematic_state_->getVariablePositions();
+  std::vector<double> theta;
+  kinematic_state_->copyJointGroupPositions(joint_model_group_, theta);
   for (std::size_t i = 0, size = static_cast<std::size_t>(delta_theta.size()); i < size; ++i)
-    theta[i] = prev_joints[i] + delta_theta(i);
+    theta[i] += delta_theta(i);
 
-  kinematic_state_->setVariablePositions(theta);
-  jacobian = kinematic_state_->getJacobian(joint_model_group_);
+  kinematic_state_->setJointGroupPositions(joint_model_group_, theta);
+  if (link)
+    kinematic_state_->getJacobian(joint_model_group_, link, Eigen::Vector3d::Zero(), jacobian);
+  else
+    jacobian = kinematic_state_->getJacobian(joint_model_group_);
   svd = Eigen::JacobiSVD<Eigen::MatrixXd>(jacobian);
   double new_condition = svd.singularValues()(0) / svd.singularValues()(svd.singularValues().size() - 1);
   // If new_condition < ini_condition, the singular vector does point towards a
@@ -817,27 +2223,31 @@ double JogCalcs::decelerateForSingularity(Eigen::MatrixXd jacobian, const Eigen:
     else if (ini_condition > parameters_.hard_stop_singularity_threshold)
     {
       velocity_scale = 0;
-      ROS_WARN_NAMED(NODE_NAME, "Close to a singularity. Halting.");
+      JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(1, NODE_NAME, "Close to a singularity. Halting.");
     }
   }
 
+  if (velocity_scale < 1)
+    raiseStatus(velocity_scale > 0 ? jog_msgs::JogStatus::DECELERATE_FOR_SINGULARITY :
+                                     jog_msgs::JogStatus::HALT_FOR_SINGULARITY,
+                "", (link ? link : joint_model_group_->getLinkModels().back())->getName());
+
   return velocity_scale;
 }
 
-bool JogCalcs::checkIfJointsWithinBounds(trajectory_msgs::JointTrajectory& new_jt_traj)
+bool JogCalcs::checkIfJointsWithinBounds(JogTrajectory& new_jt_traj)
 {
   bool halting = false;
   for (auto joint : joint_model_group_->getJointModels())
   {
     if (!kinematic_state_->satisfiesVelocityBounds(joint))
     {
-      ROS_WARN_STREAM_THROTTLE_NAMED(2, NODE_NAME, ros::this_node::getName() << " " << joint->getName() << " "
-                                                                             << " close to a "
-                                                                                " velocity limit. Enforcing limit.");
+      JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(2, NODE_NAME, "%s close to a velocity limit. Enforcing limit.",
+                                        joint->getName().c_str());
       kinematic_state_->enforceVelocityBounds(joint);
       for (std::size_t c = 0; c < new_jt_traj.joint_names.size(); ++c)
       {
-        if (new_jt_traj.joint_names[c] == joint->getName())
+        if (original_jts_.name[c] == joint->getName())
         {
           new_jt_traj.points[0].velocities[c] = kinematic_state_->getJointVelocities(joint)[0];
           break;
@@ -858,7 +2268,7 @@ bool JogCalcs::checkIfJointsWithinBounds(trajectory_msgs::JointTrajectory& new_j
     }
 
     if (!kinematic_state_->satisfiesPositionBounds(joint,
-                                                   -jog_arm::JogROSInterface::ros_parameters_.joint_limit_margin))
+                                                   -parameters_.joint_limit_margin))
     {
       const std::vector<moveit_msgs::JointLimits> limits = joint->getVariableBoundsMsg();
 
@@ -866,13 +2276,13 @@ bool JogCalcs::checkIfJointsWithinBounds(trajectory_msgs::JointTrajectory& new_j
       if (limits.size() > 0)
       {
         if ((kinematic_state_->getJointVelocities(joint)[0] < 0 &&
-             (joint_angle < (limits[0].min_position + jog_arm::JogROSInterface::ros_parameters_.joint_limit_margin))) ||
+             (joint_angle < (limits[0].min_position + parameters_.joint_limit_margin))) ||
             (kinematic_state_->getJointVelocities(joint)[0] > 0 &&
-             (joint_angle > (limits[0].max_position - jog_arm::JogROSInterface::ros_parameters_.joint_limit_margin))))
+             (joint_angle > (limits[0].max_position - parameters_.joint_limit_margin))))
         {
-          ROS_WARN_STREAM_THROTTLE_NAMED(2, NODE_NAME, ros::this_node::getName() << " " << joint->getName()
-                                                                                 << " close to a "
-                                                                                    " position limit. Halting.");
+          JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(2, NODE_NAME, "%s close to a position limit. Halting.",
+                                            joint->getName().c_str());
+          raiseStatus(jog_msgs::JogStatus::JOINT_BOUND, joint->getName());
           halting = true;
         }
       }
@@ -882,16 +2292,56 @@ bool JogCalcs::checkIfJointsWithinBounds(trajectory_msgs::JointTrajectory& new_j
   return !halting;
 }
 
-void JogCalcs::publishWarning(const bool active) const
+void JogCalcs::publishWarning(const bool active)
 {
+  if (warning_published_ && active == last_warning_)
+    return;
+
   std_msgs::Bool status;
   status.data = static_cast<std_msgs::Bool::_data_type>(active);
   warning_pub_.publish(status);
+  warning_published_ = true;
+  last_warning_ = active;
+}
+
+void JogCalcs::raiseStatus(const uint8_t code, const std::string& joint_name, const std::string& link_name)
+{
+  if (code <= status_.code)
+    return;
+  status_.code = code;
+  status_.joint_name = joint_name;
+  status_.link_name = link_name;
+}
+
+void JogCalcs::raiseCollisionStatus()
+{
+  if (!parameters_.collision_check)
+    return;
+
+  pthread_mutex_lock(&shared_variables_.collision_velocity_scale_mutex);
+  raiseStatus(shared_variables_.collision_status, "", shared_variables_.collision_link);
+  pthread_mutex_unlock(&shared_variables_.collision_velocity_scale_mutex);
+}
+
+void JogCalcs::publishStatus()
+{
+  if (!status_published_ || status_.code != published_status_.code ||
+      status_.joint_name != published_status_.joint_name || status_.link_name != published_status_.link_name)
+  {
+    status_.header.stamp = ros::Time::now();
+    status_pub_.publish(status_);
+    published_status_ = status_;
+    status_published_ = true;
+  }
+
+  status_.code = jog_msgs::JogStatus::OK;
+  status_.joint_name.clear();
+  status_.link_name.clear();
 }
 
 // Avoid a singularity or other issue.
 // Needs to be handled differently for position vs. velocity control
-void JogCalcs::halt(trajectory_msgs::JointTrajectory& jt_traj)
+void JogCalcs::halt(JogTrajectory& jt_traj)
 {
   for (std::size_t i = 0; i < jt_state_.velocity.size(); ++i)
   {
@@ -910,38 +2360,58 @@ void JogCalcs::halt(trajectory_msgs::JointTrajectory& jt_traj)
 // resumed.
 void JogCalcs::resetVelocityFilters()
 {
-  for (std::size_t i = 0; i < jt_state_.name.size(); ++i)
-    velocity_filters_[i].reset(0);  // Zero velocity
+  velocity_filters_->reset(0.);  // Zero velocity
 }
 
-// Parse the incoming joint msg for the joints of our MoveGroup
+void JogCalcs::readIncomingJoints(jog_arm_shared& shared_variables)
+{
+  pthread_mutex_lock(&shared_variables.joints_mutex);
+  incoming_joints_ = shared_variables.joints;
+  pthread_mutex_unlock(&shared_variables.joints_mutex);
+}
+
+// Take our MoveGroup's joints from the incoming frame. They are already in move group order.
 bool JogCalcs::updateJoints()
 {
+  // Check that the msg contained every joint
+  if (!incoming_joints_.complete || incoming_joints_.num_joints != jt_state_.name.size())
+    return 0;
+
+  const bool has_velocity = incoming_joints_.has_velocity;
+
   // Check if every joint was zero. Sometimes an issue.
   bool all_zeros = true;
+  for (std::size_t c = 0; c < jt_state_.name.size(); ++c)
+  {
+    jt_state_.position[c] = incoming_joints_.position[c];
+    if (has_velocity)
+      measured_velocity_[c] = incoming_joints_.velocity[c];
+    // Make sure there was at least one nonzero value
+    if (incoming_joints_.position[c] != 0.)
+      all_zeros = false;
+  }
 
-  // Check that the msg contains enough joints
-  if (incoming_jts_.name.size() < jt_state_.name.size())
+  if (all_zeros)
     return 0;
 
-  // Store joints in a member variable
-  for (std::size_t m = 0; m < incoming_jts_.name.size(); ++m)
+  // Replace the raw measurement with an estimate for this moment.
+  // Without a timestamp, the age of the measurement is unknown.
+  if (parameters_.estimate_joint_states)
   {
-    for (std::size_t c = 0; c < jt_state_.name.size(); ++c)
+    if (incoming_joints_.stamp.isZero())
     {
-      if (incoming_jts_.name[m] == jt_state_.name[c])
-      {
-        jt_state_.position[c] = incoming_jts_.position[m];
-        // Make sure there was at least one nonzero value
-        if (incoming_jts_.position[m] != 0.)
-          all_zeros = false;
-        goto NEXT_JOINT;
-      }
+      JOG_ARM_ASYNC_WARN_THROTTLE_NAMED(10, NODE_NAME, "Joint states have no timestamp. Not estimating joint states.");
+      return 1;
     }
-  NEXT_JOINT:;
+
+    const double stamp = incoming_joints_.stamp.toSec();
+    if (!joint_state_estimator_->isInitialized() || stamp > joint_state_estimator_->lastStamp())
+      joint_state_estimator_->update(stamp, jt_state_.position.data(), has_velocity ? measured_velocity_.data() : nullptr);
+
+    joint_state_estimator_->predict(ros::Time::now().toSec(), jt_state_.position.data(), jt_state_.velocity.data());
   }
 
-  return !all_zeros;
+  return 1;
 }
 
 // Scale the incoming jog command
@@ -970,7 +2440,7 @@ Eigen::VectorXd JogCalcs::scaleCartesianCommand(const geometry_msgs::TwistStampe
     result[5] = command.twist.angular.z * parameters_.publish_period;
   }
   else
-    ROS_ERROR_STREAM_NAMED(NODE_NAME, "Unexpected command_in_type");
+    JOG_ARM_ASYNC_ERROR_THROTTLE_NAMED(1, NODE_NAME, "Unexpected command_in_type");
 
   return result;
 }
@@ -998,7 +2468,7 @@ Eigen::VectorXd JogCalcs::scaleJointCommand(const jog_msgs::JogJoint& command) c
         else if (parameters_.command_in_type == "speed_units")
           result[c] = command.deltas[m] * parameters_.publish_period;
         else
-          ROS_ERROR_STREAM_NAMED(NODE_NAME, "Unexpected command_in_type");
+          JOG_ARM_ASYNC_ERROR_THROTTLE_NAMED(1, NODE_NAME, "Unexpected command_in_type");
         goto NEXT_JOINT;
       }
     }
@@ -1030,8 +2500,7 @@ bool JogCalcs::addJointIncrements(sensor_msgs::JointState& output, const Eigen::
     }
     catch (const std::out_of_range& e)
     {
-      ROS_ERROR_STREAM_NAMED(NODE_NAME, ros::this_node::getName() << " Lengths of output and "
-                                                                     "increments do not match.");
+      JOG_ARM_ASYNC_ERROR_THROTTLE_NAMED(1, NODE_NAME, "Lengths of output and increments do not match.");
       return 0;
     }
   }
@@ -1041,189 +2510,466 @@ bool JogCalcs::addJointIncrements(sensor_msgs::JointState& output, const Eigen::
 
 // Listen to cartesian delta commands.
 // Store them in a shared variable.
-void JogROSInterface::deltaCartesianCmdCB(const geometry_msgs::TwistStampedConstPtr& msg)
+void JogROSInterface::deltaCartesianCmdCB(const geometry_msgs::TwistStampedConstPtr& msg, const std::size_t group)
 {
-  pthread_mutex_lock(&shared_variables_.command_deltas_mutex);
+  leaveCoordinatedJogging(group);
+
+  pthread_mutex_lock(&shared_variables_[group].command_deltas_mutex);
 
   // Copy everything but the frame name. The frame name is set by yaml file at startup.
   // (so it isn't copied over and over)
-  shared_variables_.command_deltas.twist = msg->twist;
-  shared_variables_.command_deltas.header.stamp = msg->header.stamp;
+  shared_variables_[group].command_deltas.twist = msg->twist;
+  shared_variables_[group].command_deltas.header.stamp = msg->header.stamp;
+
+  // Back from a JogFrame command to the tip, in the yaml file's frame
+  if (shared_variables_[group].frame_cmd_flag)
+  {
+    shared_variables_[group].command_deltas.header.frame_id = getSharedParameters(group).command_frame;
+    shared_variables_[group].command_link.clear();
+    shared_variables_[group].command_avoids_collisions = true;
+    shared_variables_[group].frame_cmd_flag = false;
+  }
+  shared_variables_[group].pose_cmd_flag = false;
 
   // Check if input is all zeros. Flag it if so to skip calculations/publication
-  pthread_mutex_lock(&shared_variables_.zero_cartesian_cmd_flag_mutex);
-  shared_variables_.zero_cartesian_cmd_flag = shared_variables_.command_deltas.twist.linear.x == 0.0 &&
-                                              shared_variables_.command_deltas.twist.linear.y == 0.0 &&
-                                              shared_variables_.command_deltas.twist.linear.z == 0.0 &&
-                                              shared_variables_.command_deltas.twist.angular.x == 0.0 &&
-                                              shared_variables_.command_deltas.twist.angular.y == 0.0 &&
-                                              shared_variables_.command_deltas.twist.angular.z == 0.0;
-  pthread_mutex_unlock(&shared_variables_.zero_cartesian_cmd_flag_mutex);
+  pthread_mutex_lock(&shared_variables_[group].zero_cartesian_cmd_flag_mutex);
+  shared_variables_[group].zero_cartesian_cmd_flag = msg->twist.linear.x == 0.0 && msg->twist.linear.y == 0.0 &&
+                                                     msg->twist.linear.z == 0.0 && msg->twist.angular.x == 0.0 &&
+                                                     msg->twist.angular.y == 0.0 && msg->twist.angular.z == 0.0;
+  pthread_mutex_unlock(&shared_variables_[group].zero_cartesian_cmd_flag_mutex);
 
-  pthread_mutex_unlock(&shared_variables_.command_deltas_mutex);
+  pthread_mutex_unlock(&shared_variables_[group].command_deltas_mutex);
 
-  pthread_mutex_lock(&shared_variables_.incoming_cmd_stamp_mutex);
-  shared_variables_.incoming_cmd_stamp = msg->header.stamp;
-  pthread_mutex_unlock(&shared_variables_.incoming_cmd_stamp_mutex);
+  pthread_mutex_lock(&shared_variables_[group].incoming_cmd_stamp_mutex);
+  shared_variables_[group].incoming_cmd_stamp = msg->header.stamp;
+  pthread_mutex_unlock(&shared_variables_[group].incoming_cmd_stamp_mutex);
+
+  // Wake up an idle move group
+  if (!isZeroTwist(msg->twist))
+    resumeJogging(group);
 }
 
 // Listen to joint delta commands.
 // Store them in a shared variable.
-void JogROSInterface::deltaJointCmdCB(const jog_msgs::JogJointConstPtr& msg)
+void JogROSInterface::deltaJointCmdCB(const jog_msgs::JogJointConstPtr& msg, const std::size_t group)
 {
-  pthread_mutex_lock(&shared_variables_.joint_command_deltas_mutex);
-  shared_variables_.joint_command_deltas = *msg;
+  leaveCoordinatedJogging(group);
+
+  pthread_mutex_lock(&shared_variables_[group].joint_command_deltas_mutex);
+  shared_variables_[group].joint_command_deltas = *msg;
 
   // Check if joint inputs is all zeros. Flag it if so to skip
   // calculations/publication
   bool all_zeros = true;
-  for (double delta : shared_variables_.joint_command_deltas.deltas)
+  for (double delta : shared_variables_[group].joint_command_deltas.deltas)
   {
     all_zeros &= (delta == 0.0);
   };
-  pthread_mutex_unlock(&shared_variables_.joint_command_deltas_mutex);
+  pthread_mutex_unlock(&shared_variables_[group].joint_command_deltas_mutex);
 
-  pthread_mutex_lock(&shared_variables_.zero_joint_cmd_flag_mutex);
-  shared_variables_.zero_joint_cmd_flag = all_zeros;
-  pthread_mutex_unlock(&shared_variables_.zero_joint_cmd_flag_mutex);
+  pthread_mutex_lock(&shared_variables_[group].zero_joint_cmd_flag_mutex);
+  shared_variables_[group].zero_joint_cmd_flag = all_zeros;
+  pthread_mutex_unlock(&shared_variables_[group].zero_joint_cmd_flag_mutex);
 
-  pthread_mutex_lock(&shared_variables_.incoming_cmd_stamp_mutex);
-  shared_variables_.incoming_cmd_stamp = msg->header.stamp;
-  pthread_mutex_unlock(&shared_variables_.incoming_cmd_stamp_mutex);
+  pthread_mutex_lock(&shared_variables_[group].incoming_cmd_stamp_mutex);
+  shared_variables_[group].incoming_cmd_stamp = msg->header.stamp;
+  pthread_mutex_unlock(&shared_variables_[group].incoming_cmd_stamp_mutex);
+
+  // Wake up an idle move group
+  if (!all_zeros)
+    resumeJogging(group);
 }
 
-// Listen to joint angles.
-// Store them in a shared variable.
-void JogROSInterface::jointsCB(const sensor_msgs::JointStateConstPtr& msg)
+// Listen to the object or relative twist of a pair of move groups that are jogged together.
+// Store it in a shared variable and switch both move groups to coordinated jogging.
+void JogROSInterface::coordinatedCmdCB(const geometry_msgs::TwistStampedConstPtr& msg, const std::size_t pair,
+                                       const bool relative)
+{
+  jog_arm_coordinated_shared& coordinated_shared_variables = coordinated_shared_variables_[pair];
+  pthread_mutex_lock(&coordinated_shared_variables.command_mutex);
+
+  // Copy everything but the frame name. The frame name is set by yaml file at startup.
+  geometry_msgs::TwistStamped& command =
+      relative ? coordinated_shared_variables.relative_command : coordinated_shared_variables.object_command;
+  command.twist = msg->twist;
+  command.header.stamp = msg->header.stamp;
+
+  // Check if both inputs are all zeros. Flag it if so to skip calculations/publication
+  const bool all_zeros = isZeroTwist(coordinated_shared_variables.object_command.twist) &&
+                         isZeroTwist(coordinated_shared_variables.relative_command.twist);
+  pthread_mutex_unlock(&coordinated_shared_variables.command_mutex);
+
+  for (std::size_t group : { coordinated_pairs_[pair].first, coordinated_pairs_[pair].second })
+  {
+    jog_arm_shared& shared_variables = shared_variables_[group];
+
+    pthread_mutex_lock(&shared_variables.coordinated_cmd_flag_mutex);
+    shared_variables.coordinated_cmd_flag = true;
+    pthread_mutex_unlock(&shared_variables.coordinated_cmd_flag_mutex);
+
+    pthread_mutex_lock(&shared_variables.zero_cartesian_cmd_flag_mutex);
+    shared_variables.zero_cartesian_cmd_flag = all_zeros;
+    pthread_mutex_unlock(&shared_variables.zero_cartesian_cmd_flag_mutex);
+
+    pthread_mutex_lock(&shared_variables.zero_joint_cmd_flag_mutex);
+    shared_variables.zero_joint_cmd_flag = true;
+    pthread_mutex_unlock(&shared_variables.zero_joint_cmd_flag_mutex);
+
+    pthread_mutex_lock(&shared_variables.incoming_cmd_stamp_mutex);
+    shared_variables.incoming_cmd_stamp = msg->header.stamp;
+    pthread_mutex_unlock(&shared_variables.incoming_cmd_stamp_mutex);
+  }
+
+  // Wake up the pair, if idle
+  if (!all_zeros)
+    resumeJogging(coordinated_pairs_[pair].first);
+}
+
+// Map joystick input to Cartesian and joint commands, without serializing them
+bool JogROSInterface::directInputCB(const std::vector<float>& axes, const std::vector<int32_t>& buttons,
+                                    const std::size_t group)
 {
-  pthread_mutex_lock(&shared_variables_.joints_mutex);
-  shared_variables_.joints = *msg;
-  pthread_mutex_unlock(&shared_variables_.joints_mutex);
+  const JoyMapping& mapping = direct_input_mappings_[group];
+  std::array<double, 6> twist;
+  std::vector<double> joint_deltas;
+  applyJoyMapping(mapping, axes, buttons, twist, joint_deltas);
+  const ros::Time stamp = ros::Time::now();
+
+  geometry_msgs::TwistStampedPtr cartesian_cmd(new geometry_msgs::TwistStamped);
+  cartesian_cmd->header.stamp = stamp;
+  cartesian_cmd->twist.linear.x = twist[0];
+  cartesian_cmd->twist.linear.y = twist[1];
+  cartesian_cmd->twist.linear.z = twist[2];
+  cartesian_cmd->twist.angular.x = twist[3];
+  cartesian_cmd->twist.angular.y = twist[4];
+  cartesian_cmd->twist.angular.z = twist[5];
+  deltaCartesianCmdCB(cartesian_cmd, group);
+
+  bool all_zeros = isZeroTwist(cartesian_cmd->twist);
+  if (!mapping.joint_names.empty())
+  {
+    jog_msgs::JogJointPtr joint_cmd(new jog_msgs::JogJoint);
+    joint_cmd->header.stamp = stamp;
+    joint_cmd->joint_names = mapping.joint_names;
+    joint_cmd->deltas = joint_deltas;
+    deltaJointCmdCB(joint_cmd, group);
+    for (double delta : joint_deltas)
+      all_zeros &= (delta == 0.0);
+  }
+  return !all_zeros;
 }
 
-// Read ROS parameters, typically from YAML file
-bool JogROSInterface::readParameters(ros::NodeHandle& n)
+// A command for one move group ends coordinated jogging.
+// Its partner halts until it receives commands of its own.
+void JogROSInterface::leaveCoordinatedJogging(const std::size_t group)
 {
-  std::size_t error = 0;
+  if (partner_groups_[group] < 0)
+    return;
+  const std::size_t partner = static_cast<std::size_t>(partner_groups_[group]);
+
+  pthread_mutex_lock(&shared_variables_[group].coordinated_cmd_flag_mutex);
+  const bool coordinated = shared_variables_[group].coordinated_cmd_flag;
+  shared_variables_[group].coordinated_cmd_flag = false;
+  pthread_mutex_unlock(&shared_variables_[group].coordinated_cmd_flag_mutex);
+  if (!coordinated)
+    return;
+
+  jog_arm_shared& partner_shared_variables = shared_variables_[partner];
+  pthread_mutex_lock(&partner_shared_variables.coordinated_cmd_flag_mutex);
+  partner_shared_variables.coordinated_cmd_flag = false;
+  pthread_mutex_unlock(&partner_shared_variables.coordinated_cmd_flag_mutex);
+
+  pthread_mutex_lock(&partner_shared_variables.zero_cartesian_cmd_flag_mutex);
+  partner_shared_variables.zero_cartesian_cmd_flag = true;
+  pthread_mutex_unlock(&partner_shared_variables.zero_cartesian_cmd_flag_mutex);
+
+  pthread_mutex_lock(&partner_shared_variables.zero_joint_cmd_flag_mutex);
+  partner_shared_variables.zero_joint_cmd_flag = true;
+  pthread_mutex_unlock(&partner_shared_variables.zero_joint_cmd_flag_mutex);
+}
 
-  // Specified in the launch file. All other parameters will be read
-  // from this namespace.
-  std::string parameter_ns;
-  ros::param::get("~parameter_ns", parameter_ns);
-  if (parameter_ns == "")
+// Listen to JogFrame commands, which jog any link of a move group in any frame.
+// Store them in the shared variables of the move group they name.
+void JogROSInterface::deltaFrameCmdCB(const jog_msgs::JogFrameConstPtr& msg, const std::string& topic)
+{
+  std::size_t group = 0;
+  while (group < shared_variables_.size() &&
+         (getSharedParameters(group).frame_command_in_topic != topic ||
+          getSharedParameters(group).move_group_name != msg->group_name))
+    ++group;
+  if (group == shared_variables_.size())
   {
-    ROS_ERROR_STREAM_NAMED(NODE_NAME, "A namespace must be specified in the launch file, like:");
-    ROS_ERROR_STREAM_NAMED(NODE_NAME, "<param name=\"parameter_ns\" "
-                                      "type=\"string\" "
-                                      "value=\"left_jog_arm_server\" />");
-    return 0;
+    ROS_WARN_STREAM_THROTTLE_NAMED(2, NODE_NAME, "No move group '" << msg->group_name << "' is jogged from '" << topic
+                                                                   << "'. Skipping this datapoint.");
+    return;
   }
 
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/publish_period", ros_parameters_.publish_period);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/publish_delay", ros_parameters_.publish_delay);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/collision_check_rate", ros_parameters_.collision_check_rate);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/scale/linear", ros_parameters_.linear_scale);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/scale/rotational", ros_parameters_.rotational_scale);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/scale/joint", ros_parameters_.joint_scale);
-  error +=
-      !rosparam_shortcuts::get("", n, parameter_ns + "/low_pass_filter_coeff", ros_parameters_.low_pass_filter_coeff);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/joint_topic", ros_parameters_.joint_topic);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/command_in_type", ros_parameters_.command_in_type);
+  leaveCoordinatedJogging(group);
+
+  jog_arm_shared& shared_variables = shared_variables_[group];
+  pthread_mutex_lock(&shared_variables.command_deltas_mutex);
+  shared_variables.command_deltas.twist.linear = msg->linear_delta;
+  shared_variables.command_deltas.twist.angular = msg->angular_delta;
+  shared_variables.command_deltas.header.stamp = msg->header.stamp;
+  // Without a frame, use the yaml file's
+  shared_variables.command_deltas.header.frame_id =
+      msg->header.frame_id.empty() ? getSharedParameters(group).command_frame : msg->header.frame_id;
+  shared_variables.command_link = msg->link_name;
+  shared_variables.command_avoids_collisions = msg->avoid_collisions;
+  shared_variables.frame_cmd_flag = true;
+  shared_variables.pose_cmd_flag = false;
+
+  // Check if input is all zeros. Flag it if so to skip calculations/publication
+  const bool all_zeros = isZeroTwist(shared_variables.command_deltas.twist);
+  pthread_mutex_lock(&shared_variables.zero_cartesian_cmd_flag_mutex);
+  shared_variables.zero_cartesian_cmd_flag = all_zeros;
+  pthread_mutex_unlock(&shared_variables.zero_cartesian_cmd_flag_mutex);
+
+  pthread_mutex_unlock(&shared_variables.command_deltas_mutex);
+
+  pthread_mutex_lock(&shared_variables.incoming_cmd_stamp_mutex);
+  shared_variables.incoming_cmd_stamp = msg->header.stamp;
+  pthread_mutex_unlock(&shared_variables.incoming_cmd_stamp_mutex);
+
+  // Wake up an idle move group
+  if (!all_zeros)
+    resumeJogging(group);
+}
+
+// Listen to target poses of the tip. Servo to the latest one until the stream stops.
+void JogROSInterface::poseCmdCB(const geometry_msgs::PoseStampedConstPtr& msg, const std::size_t group)
+{
+  leaveCoordinatedJogging(group);
+
+  jog_arm_shared& shared_variables = shared_variables_[group];
+  pthread_mutex_lock(&shared_variables.command_deltas_mutex);
+  shared_variables.pose_command = *msg;
+  // Without a frame, use the yaml file's
+  if (shared_variables.pose_command.header.frame_id.empty())
+    shared_variables.pose_command.header.frame_id = getSharedParameters(group).command_frame;
+  shared_variables.pose_cmd_flag = true;
+
+  // The error from the target is only known to the worker thread, so keep calculating
+  pthread_mutex_lock(&shared_variables.zero_cartesian_cmd_flag_mutex);
+  shared_variables.zero_cartesian_cmd_flag = false;
+  pthread_mutex_unlock(&shared_variables.zero_cartesian_cmd_flag_mutex);
+
+  pthread_mutex_unlock(&shared_variables.command_deltas_mutex);
+
+  pthread_mutex_lock(&shared_variables.zero_joint_cmd_flag_mutex);
+  shared_variables.zero_joint_cmd_flag = true;
+  pthread_mutex_unlock(&shared_variables.zero_joint_cmd_flag_mutex);
+
+  pthread_mutex_lock(&shared_variables.incoming_cmd_stamp_mutex);
+  shared_variables.incoming_cmd_stamp = msg->header.stamp;
+  pthread_mutex_unlock(&shared_variables.incoming_cmd_stamp_mutex);
+
+  // Wake up an idle move group
+  resumeJogging(group);
+}
+
+// Listen to joint angles.
+// Share them with every move group that listens to this topic, each in its own joint order.
+// A move group keeps its last joints if the msg doesn't have all of them.
+void JogROSInterface::jointsCB(const boost::shared_ptr<const ParsedJointState>& msg, const std::string& topic)
+{
+  if (!msg->valid)
+  {
+    ROS_WARN_STREAM_THROTTLE_NAMED(10, NODE_NAME, "Malformed sensor_msgs/JointState on '" << topic << "'");
+    return;
+  }
+
+  const JointStateFrame& frame = msg->frame;
+  for (std::size_t group = 0; group < shared_variables_.size(); ++group)
+  {
+    if (getSharedParameters(group).joint_topic != topic)
+      continue;
+
+    const std::vector<std::size_t>& indices = joint_frame_indices_[group];
+    bool has_group = true;
+    for (const std::size_t index : indices)
+      has_group = has_group && frame.found[index];
+    if (!has_group)
+      continue;
+
+    jog_arm_shared& shared_variables = shared_variables_[group];
+    pthread_mutex_lock(&shared_variables.joints_mutex);
+    JointStateFrame& joints = shared_variables.joints;
+    joints.stamp = frame.stamp;
+    joints.num_joints = indices.size();
+    joints.complete = true;
+    joints.has_velocity = frame.has_velocity;
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+      joints.position[i] = frame.position[indices[i]];
+      joints.found[i] = true;
+      if (frame.has_velocity)
+        joints.velocity[i] = frame.velocity[indices[i]];
+    }
+    pthread_mutex_unlock(&shared_variables.joints_mutex);
+  }
+}
+
+// Read ROS parameters, typically from YAML file
+bool JogROSInterface::readParameters(ros::NodeHandle& n, const std::string& parameter_ns,
+                                     jog_arm_parameters& parameters)
+{
+  const std::size_t error = readParameterValues(n, parameter_ns, parameters);
+  rosparam_shortcuts::shutdownIfError(parameter_ns, error);
+
+  return validateParameters(parameters);
+}
+
+std::size_t JogROSInterface::readParameterValues(ros::NodeHandle& n, const std::string& parameter_ns,
+                                                 jog_arm_parameters& parameters)
+{
+  std::size_t error = 0;
+
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/publish_period", parameters.publish_period);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/publish_delay", parameters.publish_delay);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/collision_check_rate", parameters.collision_check_rate);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/scale/linear", parameters.linear_scale);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/scale/rotational", parameters.rotational_scale);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/scale/joint", parameters.joint_scale);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/joint_topic", parameters.joint_topic);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/command_in_type", parameters.command_in_type);
   error += !rosparam_shortcuts::get("", n, parameter_ns + "/cartesian_command_in_topic",
-                                    ros_parameters_.cartesian_command_in_topic);
+                                    parameters.cartesian_command_in_topic);
   error +=
-      !rosparam_shortcuts::get("", n, parameter_ns + "/joint_command_in_topic", ros_parameters_.joint_command_in_topic);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/command_frame", ros_parameters_.command_frame);
+      !rosparam_shortcuts::get("", n, parameter_ns + "/joint_command_in_topic", parameters.joint_command_in_topic);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/command_frame", parameters.command_frame);
   error += !rosparam_shortcuts::get("", n, parameter_ns + "/incoming_command_timeout",
-                                    ros_parameters_.incoming_command_timeout);
+                                    parameters.incoming_command_timeout);
   error += !rosparam_shortcuts::get("", n, parameter_ns + "/lower_singularity_threshold",
-                                    ros_parameters_.lower_singularity_threshold);
+                                    parameters.lower_singularity_threshold);
   error += !rosparam_shortcuts::get("", n, parameter_ns + "/hard_stop_singularity_threshold",
-                                    ros_parameters_.hard_stop_singularity_threshold);
+                                    parameters.hard_stop_singularity_threshold);
   error += !rosparam_shortcuts::get("", n, parameter_ns + "/lower_collision_proximity_threshold",
-                                    ros_parameters_.lower_collision_proximity_threshold);
+                                    parameters.lower_collision_proximity_threshold);
   error += !rosparam_shortcuts::get("", n, parameter_ns + "/hard_stop_collision_proximity_threshold",
-                                    ros_parameters_.hard_stop_collision_proximity_threshold);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/move_group_name", ros_parameters_.move_group_name);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/planning_frame", ros_parameters_.planning_frame);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/gazebo", ros_parameters_.gazebo);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/collision_check", ros_parameters_.collision_check);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/warning_topic", ros_parameters_.warning_topic);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/joint_limit_margin", ros_parameters_.joint_limit_margin);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/command_out_topic", ros_parameters_.command_out_topic);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/command_out_type", ros_parameters_.command_out_type);
+                                    parameters.hard_stop_collision_proximity_threshold);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/move_group_name", parameters.move_group_name);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/planning_frame", parameters.planning_frame);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/gazebo", parameters.gazebo);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/collision_check", parameters.collision_check);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/warning_topic", parameters.warning_topic);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/joint_limit_margin", parameters.joint_limit_margin);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/command_out_topic", parameters.command_out_topic);
+  error += !rosparam_shortcuts::get("", n, parameter_ns + "/command_out_type", parameters.command_out_type);
   error += !rosparam_shortcuts::get("", n, parameter_ns + "/publish_joint_positions",
-                                    ros_parameters_.publish_joint_positions);
+                                    parameters.publish_joint_positions);
   error += !rosparam_shortcuts::get("", n, parameter_ns + "/publish_joint_velocities",
-                                    ros_parameters_.publish_joint_velocities);
-  error += !rosparam_shortcuts::get("", n, parameter_ns + "/publish_joint_accelerations",
-                                    ros_parameters_.publish_joint_accelerations);
-
-  rosparam_shortcuts::shutdownIfError(parameter_ns, error);
-
-  // Set the input frame, as determined by YAML file:
-  pthread_mutex_lock(&shared_variables_.command_deltas_mutex);
-  shared_variables_.command_deltas.header.frame_id = ros_parameters_.command_frame;
-  pthread_mutex_unlock(&shared_variables_.command_deltas_mutex);
+                                    parameters.publish_joint_velocities);
+  error += readFilterParameters(n, parameter_ns, parameters);
+
+  // Optional features. Older yaml files don't have them, so the defaults keep the old behavior.
+  n.param(parameter_ns + "/smoothing/enabled", parameters.smoothing, false);
+  n.param(parameter_ns + "/smoothing/max_acceleration", parameters.max_joint_acceleration, 3.);
+  n.param(parameter_ns + "/smoothing/max_jerk", parameters.max_joint_jerk, 30.);
+  n.param(parameter_ns + "/publish_joint_accelerations", parameters.publish_joint_accelerations, false);
+  n.param(parameter_ns + "/enforce_acceleration_limits", parameters.enforce_acceleration_limits, false);
+  n.param(parameter_ns + "/joint_state_estimator/enabled", parameters.estimate_joint_states, false);
+  n.param(parameter_ns + "/joint_state_estimator/alpha", parameters.joint_state_estimator_alpha, 0.5);
+  n.param(parameter_ns + "/joint_state_estimator/beta", parameters.joint_state_estimator_beta, 0.2);
+  n.param(parameter_ns + "/coordinated_jogging/enabled", parameters.coordinated_jogging, false);
+  n.param<std::string>(parameter_ns + "/coordinated_jogging/partner_move_group_name",
+                       parameters.coordinated_partner_move_group_name, "");
+  n.param<std::string>(parameter_ns + "/coordinated_jogging/object_command_in_topic",
+                       parameters.object_command_in_topic, "jog_arm_server/object_jog_cmds");
+  n.param<std::string>(parameter_ns + "/coordinated_jogging/relative_command_in_topic",
+                       parameters.relative_command_in_topic, "jog_arm_server/relative_jog_cmds");
+  n.param(parameter_ns + "/direct_input/enabled", parameters.direct_input, false);
+  n.param<std::string>(parameter_ns + "/direct_input/device", parameters.direct_input_device, "");
+  n.param<std::string>(parameter_ns + "/frame_command_in_topic", parameters.frame_command_in_topic,
+                       "jog_arm_server/jog_frame_cmds");
+  n.param<std::string>(parameter_ns + "/pose_tracking/pose_command_in_topic", parameters.pose_command_in_topic,
+                       "jog_arm_server/target_pose");
+  n.param(parameter_ns + "/pose_tracking/linear_gain", parameters.pose_linear_gain, 2.);
+  n.param(parameter_ns + "/pose_tracking/angular_gain", parameters.pose_angular_gain, 2.);
+  n.param(parameter_ns + "/pose_tracking/max_linear_velocity", parameters.pose_max_linear_velocity, 0.2);
+  n.param(parameter_ns + "/pose_tracking/max_angular_velocity", parameters.pose_max_angular_velocity, 0.5);
+  n.param(parameter_ns + "/drift_correction/enabled", parameters.correct_drift, false);
+  n.param(parameter_ns + "/drift_correction/gain", parameters.drift_correction_gain, 0.5);
+  n.param(parameter_ns + "/drift_correction/ik_period", parameters.drift_correction_ik_period, 0.);
+  n.param(parameter_ns + "/drift_correction/ik_timeout", parameters.drift_correction_ik_timeout, 0.002);
+  n.param(parameter_ns + "/null_space/joint_limit_gain", parameters.null_space_joint_limit_gain, 0.);
+  n.param(parameter_ns + "/null_space/manipulability_gain", parameters.null_space_manipulability_gain, 0.);
+  n.param(parameter_ns + "/null_space/posture_gain", parameters.null_space_posture_gain, 0.);
+  n.param(parameter_ns + "/null_space/posture", parameters.null_space_posture, std::vector<double>());
+  n.param(parameter_ns + "/use_arena_allocator", parameters.use_arena_allocator, false);
+  n.param<std::string>(parameter_ns + "/status_topic", parameters.status_topic, "jog_arm_server/status");
+
+  return error;
+}
 
-  // Input checking
-  if (ros_parameters_.hard_stop_singularity_threshold < ros_parameters_.lower_singularity_threshold)
+// Input checking
+bool JogROSInterface::validateParameters(const jog_arm_parameters& parameters)
+{
+  if (parameters.hard_stop_singularity_threshold < parameters.lower_singularity_threshold)
   {
     ROS_WARN_NAMED(NODE_NAME, "Parameter 'hard_stop_singularity_threshold' "
                               "should be greater than 'lower_singularity_threshold.' "
                               "Check yaml file.");
     return 0;
   }
-  if ((ros_parameters_.hard_stop_singularity_threshold < 0.) || (ros_parameters_.lower_singularity_threshold < 0.))
+  if ((parameters.hard_stop_singularity_threshold < 0.) || (parameters.lower_singularity_threshold < 0.))
   {
     ROS_WARN_NAMED(NODE_NAME, "Parameters 'hard_stop_singularity_threshold' "
                               "and 'lower_singularity_threshold' should be "
                               "greater than zero. Check yaml file.");
     return 0;
   }
-  if (ros_parameters_.hard_stop_collision_proximity_threshold >= ros_parameters_.lower_collision_proximity_threshold)
+  if (parameters.hard_stop_collision_proximity_threshold >= parameters.lower_collision_proximity_threshold)
   {
     ROS_WARN_NAMED(NODE_NAME, "Parameter 'hard_stop_collision_proximity_threshold' "
                               "should be less than 'lower_collision_proximity_threshold.' "
                               "Check yaml file.");
     return 0;
   }
-  if ((ros_parameters_.hard_stop_collision_proximity_threshold < 0.) ||
-      (ros_parameters_.lower_collision_proximity_threshold < 0.))
+  if ((parameters.hard_stop_collision_proximity_threshold < 0.) ||
+      (parameters.lower_collision_proximity_threshold < 0.))
   {
     ROS_WARN_NAMED(NODE_NAME, "Parameters 'hard_stop_collision_proximity_threshold' "
                               "and 'lower_collision_proximity_threshold' should be "
                               "greater than zero. Check yaml file.");
     return 0;
   }
-  if (ros_parameters_.low_pass_filter_coeff < 0.)
+  FilterType filter_type;
+  if (!parseFilterType(parameters.low_pass_filter_type, filter_type))
   {
-    ROS_WARN_NAMED(NODE_NAME, "Parameter 'low_pass_filter_coeff' should be "
-                              "greater than zero. Check yaml file.");
+    ROS_WARN_NAMED(NODE_NAME, "Parameter 'low_pass_filter/type' should be "
+                              "'butterworth', 'critically_damped' or 'one_euro'. "
+                              "Check yaml file.");
+    return 0;
+  }
+  const std::string filter_error = LowPassFilterBank::validate(getJointFilterSpec(parameters));
+  if (!filter_error.empty())
+  {
+    ROS_WARN_STREAM_NAMED(NODE_NAME, filter_error << " Check the 'low_pass_filter' block of the yaml file.");
     return 0;
   }
-  if (ros_parameters_.joint_limit_margin < 0.)
+  if (parameters.joint_limit_margin < 0.)
   {
     ROS_WARN_NAMED(NODE_NAME, "Parameter 'joint_limit_margin' should be "
                               "greater than zero. Check yaml file.");
     return 0;
   }
-  if (ros_parameters_.command_in_type != "unitless" && ros_parameters_.command_in_type != "speed_units")
+  if (parameters.command_in_type != "unitless" && parameters.command_in_type != "speed_units")
   {
     ROS_WARN_NAMED(NODE_NAME, "command_in_type should be 'unitless' or "
                               "'speed_units'. Check yaml file.");
     return 0;
   }
-  if (ros_parameters_.command_out_type != "trajectory_msgs/JointTrajectory" &&
-      ros_parameters_.command_out_type != "std_msgs/Float64MultiArray")
+  if (parameters.command_out_type != "trajectory_msgs/JointTrajectory" &&
+      parameters.command_out_type != "std_msgs/Float64MultiArray")
   {
     ROS_WARN_NAMED(NODE_NAME, "Parameter command_out_type should be "
                               "'trajectory_msgs/JointTrajectory' or "
                               "'std_msgs/Float64MultiArray'. Check yaml file.");
     return 0;
   }
-  if (!ros_parameters_.publish_joint_positions && !ros_parameters_.publish_joint_velocities &&
-      !ros_parameters_.publish_joint_accelerations)
+  if (!parameters.publish_joint_positions && !parameters.publish_joint_velocities &&
+      !parameters.publish_joint_accelerations)
   {
     ROS_WARN_NAMED(NODE_NAME, "At least one of publish_joint_positions / "
                               "publish_joint_velocities / "
@@ -1231,20 +2977,163 @@ bool JogROSInterface::readParameters(ros::NodeHandle& n)
                               "yaml file.");
     return 0;
   }
-  if ((ros_parameters_.command_out_type == "std_msgs/Float64MultiArray") && ros_parameters_.publish_joint_positions &&
-      ros_parameters_.publish_joint_velocities)
+  if ((parameters.command_out_type == "std_msgs/Float64MultiArray") && parameters.publish_joint_positions &&
+      parameters.publish_joint_velocities)
   {
     ROS_WARN_NAMED(NODE_NAME, "When publishing a std_msgs/Float64MultiArray, "
                               "you must select positions OR velocities.");
     return 0;
   }
-  if (ros_parameters_.collision_check_rate < 0)
+  if (parameters.smoothing &&
+      (parameters.max_joint_acceleration <= 0. || parameters.max_joint_jerk <= 0.))
+  {
+    ROS_WARN_NAMED(NODE_NAME, "Parameters 'smoothing/max_acceleration' and "
+                              "'smoothing/max_jerk' should be greater than zero. "
+                              "Check yaml file.");
+    return 0;
+  }
+  const std::string estimator_error = JointStateEstimator::validate(parameters.joint_state_estimator_alpha,
+                                                                     parameters.joint_state_estimator_beta);
+  if (parameters.estimate_joint_states && !estimator_error.empty())
+  {
+    ROS_WARN_STREAM_NAMED(NODE_NAME, "Parameters 'joint_state_estimator': " << estimator_error << " Check yaml file.");
+    return 0;
+  }
+  if (parameters.coordinated_jogging && (parameters.coordinated_partner_move_group_name.empty() ||
+                                         parameters.coordinated_partner_move_group_name == parameters.move_group_name))
+  {
+    ROS_WARN_NAMED(NODE_NAME, "Parameter 'coordinated_jogging/partner_move_group_name' should name "
+                              "another move group. Check yaml file.");
+    return 0;
+  }
+  if (parameters.direct_input && parameters.direct_input_device.empty())
+  {
+    ROS_WARN_NAMED(NODE_NAME, "Parameter 'direct_input/device' should name an evdev device. Check yaml file.");
+    return 0;
+  }
+  if (parameters.collision_check_rate < 0)
   {
     ROS_WARN_NAMED(NODE_NAME, "Parameter 'collision_check_rate' should be "
                               "greater than zero. Check yaml file.");
     return 0;
   }
 
+  if (parameters.drift_correction_gain < 0. || parameters.drift_correction_gain > 1. ||
+      parameters.drift_correction_ik_period < 0. || parameters.drift_correction_ik_timeout < 0.)
+  {
+    ROS_WARN_NAMED(NODE_NAME, "Parameter 'drift_correction/gain' should be in [0:1], and 'ik_period' and "
+                              "'ik_timeout' should not be negative. Check yaml file.");
+    return 0;
+  }
+  if (parameters.null_space_joint_limit_gain < 0. || parameters.null_space_manipulability_gain < 0. ||
+      parameters.null_space_posture_gain < 0.)
+  {
+    ROS_WARN_NAMED(NODE_NAME, "Parameters 'null_space/*_gain' should not be negative. Check yaml file.");
+    return 0;
+  }
+  if (parameters.pose_linear_gain < 0. || parameters.pose_angular_gain < 0. ||
+      parameters.pose_max_linear_velocity <= 0. || parameters.pose_max_angular_velocity <= 0.)
+  {
+    ROS_WARN_NAMED(NODE_NAME, "Parameters 'pose_tracking/linear_gain' and 'angular_gain' should not be negative, "
+                              "and the maximum velocities should be greater than zero. Check yaml file.");
+    return 0;
+  }
+
   return 1;
 }
+
+// Topics, the move group and anything that decides which objects start() creates are fixed
+std::string JogROSInterface::getFixedParameterChange(const jog_arm_parameters& current,
+                                                     const jog_arm_parameters& reloaded)
+{
+  if (reloaded.move_group_name != current.move_group_name)
+    return "move_group_name";
+  if (reloaded.joint_topic != current.joint_topic)
+    return "joint_topic";
+  if (reloaded.cartesian_command_in_topic != current.cartesian_command_in_topic)
+    return "cartesian_command_in_topic";
+  if (reloaded.joint_command_in_topic != current.joint_command_in_topic)
+    return "joint_command_in_topic";
+  if (reloaded.frame_command_in_topic != current.frame_command_in_topic)
+    return "frame_command_in_topic";
+  if (reloaded.pose_command_in_topic != current.pose_command_in_topic)
+    return "pose_tracking/pose_command_in_topic";
+  if (reloaded.command_out_topic != current.command_out_topic)
+    return "command_out_topic";
+  if (reloaded.command_out_type != current.command_out_type)
+    return "command_out_type";
+  if (reloaded.warning_topic != current.warning_topic)
+    return "warning_topic";
+  if (reloaded.status_topic != current.status_topic)
+    return "status_topic";
+  if (reloaded.command_frame != current.command_frame)
+    return "command_frame";
+  if (reloaded.planning_frame != current.planning_frame)
+    return "planning_frame";
+  if (reloaded.publish_period != current.publish_period)
+    return "publish_period";
+  if (reloaded.collision_check != current.collision_check)
+    return "collision_check";
+  if (reloaded.smoothing != current.smoothing)
+    return "smoothing/enabled";
+  if (reloaded.correct_drift != current.correct_drift)
+    return "drift_correction/enabled";
+  if (reloaded.estimate_joint_states != current.estimate_joint_states)
+    return "joint_state_estimator/enabled";
+  if (reloaded.coordinated_jogging != current.coordinated_jogging ||
+      reloaded.coordinated_partner_move_group_name != current.coordinated_partner_move_group_name ||
+      reloaded.object_command_in_topic != current.object_command_in_topic ||
+      reloaded.relative_command_in_topic != current.relative_command_in_topic)
+    return "coordinated_jogging";
+  if (reloaded.direct_input != current.direct_input || reloaded.direct_input_device != current.direct_input_device)
+    return "direct_input";
+  return "";
+}
+
+std::size_t JogROSInterface::readFilterParameters(ros::NodeHandle& n, const std::string& parameter_ns,
+                                                  jog_arm_parameters& parameters)
+{
+  std::size_t error = 0;
+
+  if (n.hasParam(parameter_ns + "/low_pass_filter"))
+  {
+    error += !rosparam_shortcuts::get("", n, parameter_ns + "/low_pass_filter/type",
+                                      parameters.low_pass_filter_type);
+    error += !rosparam_shortcuts::get("", n, parameter_ns + "/low_pass_filter/order",
+                                      parameters.low_pass_filter_order);
+    error += !rosparam_shortcuts::get("", n, parameter_ns + "/low_pass_filter/cutoff_frequency",
+                                      parameters.low_pass_filter_cutoff_frequency);
+    error += !rosparam_shortcuts::get("", n, parameter_ns + "/low_pass_filter/one_euro_beta",
+                                      parameters.one_euro_beta);
+    error += !rosparam_shortcuts::get("", n, parameter_ns + "/low_pass_filter/one_euro_derivative_cutoff",
+                                      parameters.one_euro_derivative_cutoff);
+    return error;
+  }
+
+  // Older yaml files give a dimensionless coefficient, whose effect depends on publish_period.
+  // Convert it to the equivalent 2nd-order Butterworth.
+  double low_pass_filter_coeff = 0.;
+  if (!rosparam_shortcuts::get("", n, parameter_ns + "/low_pass_filter_coeff", low_pass_filter_coeff))
+    return error + 1;
+  if (low_pass_filter_coeff <= 0.)
+  {
+    ROS_WARN_NAMED(NODE_NAME, "Parameter 'low_pass_filter_coeff' should be "
+                              "greater than zero. Check yaml file.");
+    return error + 1;
+  }
+
+  parameters.low_pass_filter_type = "butterworth";
+  parameters.low_pass_filter_order = 2;
+  parameters.low_pass_filter_cutoff_frequency =
+      LowPassFilterBank::cutoffFromCoefficient(low_pass_filter_coeff, parameters.publish_period);
+  parameters.one_euro_beta = 0.;
+  parameters.one_euro_derivative_cutoff = 1.;
+
+  // Once is enough, not again on every reload
+  if (!started_)
+    ROS_WARN_STREAM_NAMED(NODE_NAME, "Parameter 'low_pass_filter_coeff' is deprecated. Use the 'low_pass_filter' "
+                                     "block instead. Equivalent cutoff_frequency: "
+                                         << parameters.low_pass_filter_cutoff_frequency << " Hz");
+  return error;
+}
 }  // namespace jog_arm
@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : jog_arm_server_node.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Runs a jog arm server for the move groups given in the launch file.
+
+#include <jog_arm/jog_arm_server.h>
+#include <algorithm>
+
+static const char* const NODE_NAME = "jog_arm_server";
+
+// MAIN
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, NODE_NAME);
+
+  // Specified in the launch file. All other parameters will be read
+  // from these namespaces, one per move group.
+  std::vector<std::string> parameter_namespaces;
+  ros::param::get("~parameter_namespaces", parameter_namespaces);
+  if (parameter_namespaces.empty())
+  {
+    std::string parameter_ns;
+    ros::param::get("~parameter_ns", parameter_ns);
+    if (parameter_ns != "")
+      parameter_namespaces.push_back(parameter_ns);
+  }
+  if (parameter_namespaces.empty())
+  {
+    ROS_ERROR_STREAM_NAMED(NODE_NAME, "A namespace must be specified in the launch file, like:");
+    ROS_ERROR_STREAM_NAMED(NODE_NAME, "<param name=\"parameter_ns\" "
+                                      "type=\"string\" "
+                                      "value=\"left_jog_arm_server\" />");
+    ROS_ERROR_STREAM_NAMED(NODE_NAME, "or, to jog several move groups:");
+    ROS_ERROR_STREAM_NAMED(NODE_NAME, "<rosparam param=\"parameter_namespaces\">"
+                                      "[left_jog_arm_server, right_jog_arm_server]</rosparam>");
+    exit(EXIT_FAILURE);
+  }
+
+  // Zero means one worker thread per core
+  int num_worker_threads;
+  ros::param::param<int>("~num_worker_threads", num_worker_threads, 0);
+  std::shared_ptr<jog_arm::PeriodicTaskExecutor> executor =
+      std::make_shared<jog_arm::PeriodicTaskExecutor>(std::max(num_worker_threads, 0));
+
+  ros::NodeHandle n;
+  jog_arm::JogROSInterface ros_interface(n, parameter_namespaces, nullptr, executor);
+  if (!ros_interface.start())
+    exit(EXIT_FAILURE);
+  ros_interface.run();
+
+  // Join every thread that logs, then write the last messages while rosconsole is still up
+  ros_interface.stop();
+  executor->stop();
+  jog_arm::AsyncLog::instance().stop();
+
+  return 0;
+}
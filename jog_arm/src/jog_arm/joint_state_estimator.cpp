@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : joint_state_estimator.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Filtered, latency-compensated joint positions and velocities.
+
+#include <jog_arm/joint_state_estimator.h>
+#include <algorithm>
+
+namespace jog_arm
+{
+// If measurements stop for this long [s], start over from the next one
+static const double MEASUREMENT_TIMEOUT = 0.5;
+
+JointStateEstimator::JointStateEstimator(const std::size_t num_joints, const double alpha, const double beta)
+  : alpha_(alpha)
+  , beta_(beta)
+  , position_(Eigen::VectorXd::Zero(num_joints))
+  , velocity_(Eigen::VectorXd::Zero(num_joints))
+  , commanded_velocity_(Eigen::VectorXd::Zero(num_joints))
+{
+}
+
+void JointStateEstimator::setGains(const double alpha, const double beta)
+{
+  alpha_ = alpha;
+  beta_ = beta;
+}
+
+std::string JointStateEstimator::validate(const double alpha, const double beta)
+{
+  // Stability region of the alpha-beta filter
+  if (alpha <= 0. || alpha > 1.)
+    return "alpha should be in (0, 1].";
+  if (beta < 0. || beta >= 4. - 2. * alpha)
+    return "beta should be in [0, 4-2*alpha).";
+
+  return "";
+}
+
+void JointStateEstimator::initialize(const double stamp, const double* position, const double* velocity)
+{
+  position_ = Eigen::Map<const Eigen::VectorXd>(position, position_.size());
+  if (velocity)
+    velocity_ = Eigen::Map<const Eigen::VectorXd>(velocity, velocity_.size());
+  else
+    velocity_.setZero();
+
+  stamp_ = stamp;
+  initialized_ = true;
+}
+
+void JointStateEstimator::update(const double stamp, const double* position, const double* velocity)
+{
+  const double dt = stamp - stamp_;
+
+  if (!initialized_ || dt > MEASUREMENT_TIMEOUT)
+  {
+    initialize(stamp, position, velocity);
+    return;
+  }
+
+  // Out of order or repeated
+  if (dt <= 0.)
+    return;
+
+  const Eigen::Map<const Eigen::VectorXd> measured_position(position, position_.size());
+
+  // Predict to the measurement time, then correct
+  position_ += velocity_ * dt;
+  const Eigen::VectorXd residual = measured_position - position_;
+  position_ += alpha_ * residual;
+  velocity_ += (beta_ / dt) * residual;
+
+  // Some drivers measure velocity directly
+  if (velocity)
+    velocity_ += alpha_ * (Eigen::Map<const Eigen::VectorXd>(velocity, velocity_.size()) - velocity_);
+
+  stamp_ = stamp;
+}
+
+void JointStateEstimator::setCommandedVelocity(const Eigen::VectorXd& commanded_velocity)
+{
+  velocity_ += commanded_velocity - commanded_velocity_;
+  commanded_velocity_ = commanded_velocity;
+}
+
+void JointStateEstimator::predict(const double time, double* position, double* velocity) const
+{
+  // Don't extrapolate across a gap in measurements
+  const double dt = std::min(std::max(time - stamp_, 0.), MEASUREMENT_TIMEOUT);
+
+  Eigen::Map<Eigen::VectorXd>(position, position_.size()) = position_ + velocity_ * dt;
+  if (velocity)
+    Eigen::Map<Eigen::VectorXd>(velocity, velocity_.size()) = velocity_;
+}
+}  // namespace jog_arm
@@ -0,0 +1,187 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : joint_state_parser.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Reads move group joints straight from serialized sensor_msgs/JointState msgs.
+
+#include <jog_arm/joint_state_parser.h>
+#include <algorithm>
+#include <cstring>
+
+namespace jog_arm
+{
+// Bounds-checked reads from a serialized msg. They return false past the end.
+static bool readUint32(const uint8_t* data, const uint32_t length, uint32_t& offset, uint32_t& value)
+{
+  if (offset > length || length - offset < sizeof(value))
+    return false;
+  std::memcpy(&value, data + offset, sizeof(value));
+  offset += sizeof(value);
+  return true;
+}
+
+static bool skipBytes(const uint32_t length, uint32_t& offset, const uint64_t count)
+{
+  if (offset > length || length - offset < count)
+    return false;
+  offset += static_cast<uint32_t>(count);
+  return true;
+}
+
+JointStateParser::JointStateParser()
+{
+  pthread_mutex_init(&mutex_, nullptr);
+}
+
+JointStateParser::~JointStateParser()
+{
+  pthread_mutex_destroy(&mutex_);
+}
+
+bool JointStateParser::addJoints(const std::vector<std::string>& names, std::vector<std::size_t>& frame_indices)
+{
+  pthread_mutex_lock(&mutex_);
+  bool fits = true;
+  frame_indices.clear();
+  for (const std::string& name : names)
+  {
+    std::vector<std::string>::const_iterator existing = std::find(names_.begin(), names_.end(), name);
+    if (existing == names_.end())
+    {
+      if (names_.size() == MAX_FRAME_JOINTS)
+      {
+        fits = false;
+        break;
+      }
+      existing = names_.insert(names_.end(), name);
+    }
+    frame_indices.push_back(static_cast<std::size_t>(existing - names_.begin()));
+  }
+
+  // Look the names up again in the next msg
+  msg_names_.clear();
+  pthread_mutex_unlock(&mutex_);
+  return fits;
+}
+
+bool JointStateParser::parse(const uint8_t* data, const uint32_t length, JointStateFrame& frame)
+{
+  pthread_mutex_lock(&mutex_);
+  const bool valid = parseLocked(data, length, frame);
+  pthread_mutex_unlock(&mutex_);
+  return valid;
+}
+
+bool JointStateParser::parseLocked(const uint8_t* data, const uint32_t length, JointStateFrame& frame)
+{
+  frame.complete = false;
+  frame.num_joints = names_.size();
+  std::fill(frame.found, frame.found + names_.size(), false);
+
+  // Header: seq, stamp, frame_id
+  uint32_t offset = 4, string_length;
+  if (!readUint32(data, length, offset, frame.stamp.sec) || !readUint32(data, length, offset, frame.stamp.nsec) ||
+      !readUint32(data, length, offset, string_length) || !skipBytes(length, offset, string_length))
+    return false;
+
+  // Names. Only looked at again if they changed.
+  const uint32_t names_offset = offset;
+  uint32_t num_names;
+  if (!readUint32(data, length, offset, num_names))
+    return false;
+  for (uint32_t i = 0; i < num_names; ++i)
+  {
+    if (!readUint32(data, length, offset, string_length) || !skipBytes(length, offset, string_length))
+      return false;
+  }
+  const uint32_t names_length = offset - names_offset;
+  if (msg_names_.size() != names_length || std::memcmp(msg_names_.data(), data + names_offset, names_length) != 0)
+    indexNames(data + names_offset, names_length, num_names);
+
+  // Positions, then velocities. Efforts are not needed.
+  uint32_t num_positions, num_velocities;
+  if (!readUint32(data, length, offset, num_positions))
+    return false;
+  const uint8_t* positions = data + offset;
+  if (!skipBytes(length, offset, static_cast<uint64_t>(num_positions) * sizeof(double)) ||
+      !readUint32(data, length, offset, num_velocities))
+    return false;
+  const uint8_t* velocities = data + offset;
+  if (!skipBytes(length, offset, static_cast<uint64_t>(num_velocities) * sizeof(double)))
+    return false;
+
+  // A msg may have only some of the joints, e.g. when each arm's driver publishes its own
+  frame.has_velocity = num_velocities == num_names;
+  frame.complete = true;
+  for (std::size_t i = 0; i < names_.size(); ++i)
+  {
+    const int index = msg_indices_[i];
+    if (index < 0 || static_cast<uint32_t>(index) >= num_positions)
+    {
+      frame.complete = false;
+      continue;
+    }
+    std::memcpy(&frame.position[i], positions + index * sizeof(double), sizeof(double));
+    if (frame.has_velocity)
+      std::memcpy(&frame.velocity[i], velocities + index * sizeof(double), sizeof(double));
+    frame.found[i] = true;
+  }
+
+  return true;
+}
+
+void JointStateParser::indexNames(const uint8_t* data, const uint32_t length, const uint32_t count)
+{
+  msg_names_.assign(data, data + length);
+  msg_indices_.assign(names_.size(), -1);
+
+  // Bounds were checked by parse()
+  uint32_t offset = 4, string_length;
+  for (uint32_t m = 0; m < count; ++m)
+  {
+    readUint32(data, length, offset, string_length);
+    const char* name = reinterpret_cast<const char*>(data + offset);
+    for (std::size_t i = 0; i < names_.size(); ++i)
+    {
+      if (msg_indices_[i] < 0 && names_[i].size() == string_length &&
+          std::memcmp(names_[i].data(), name, string_length) == 0)
+        msg_indices_[i] = static_cast<int>(m);
+    }
+    offset += string_length;
+  }
+}
+}  // namespace jog_arm
@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : joy_mapping.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <jog_arm/joy_mapping.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace jog_arm
+{
+static const std::string NODE_NAME = "joy_mapping";
+
+const std::array<std::string, 6> TWIST_COMPONENT_NAMES = { { "linear_x", "linear_y", "linear_z", "angular_x",
+                                                             "angular_y", "angular_z" } };
+
+double JoyInputMapping::apply(const std::vector<float>& axes, const std::vector<int32_t>& buttons) const
+{
+  double value = 0.;
+  if (axis >= 0)
+  {
+    if (static_cast<std::size_t>(axis) < axes.size())
+      value = axes[axis];
+  }
+  else
+  {
+    if (positive_button >= 0 && static_cast<std::size_t>(positive_button) < buttons.size() &&
+        buttons[positive_button])
+      value += 1.;
+    if (negative_button >= 0 && static_cast<std::size_t>(negative_button) < buttons.size() &&
+        buttons[negative_button])
+      value -= 1.;
+  }
+
+  const double magnitude = std::abs(value);
+  if (magnitude <= deadzone)
+    return 0.;
+
+  // Stretch what is left of the range, so the output starts from zero at the edge of the deadzone
+  const double stretched = std::min(1., (magnitude - deadzone) / (1. - deadzone));
+  return std::copysign(std::pow(stretched, exponent), value) * scale;
+}
+
+std::string validateJoyInputMapping(const JoyInputMapping& mapping)
+{
+  if (mapping.axis >= 0 && (mapping.positive_button >= 0 || mapping.negative_button >= 0))
+    return "Map an axis or buttons, not both.";
+  if (mapping.deadzone < 0. || mapping.deadzone >= 1.)
+    return "'deadzone' should be in [0:1).";
+  if (mapping.exponent <= 0.)
+    return "'exponent' should be greater than zero.";
+  return "";
+}
+
+static bool readJoyInputMapping(const ros::NodeHandle& n, const std::string& ns, JoyInputMapping& mapping)
+{
+  n.param(ns + "/axis", mapping.axis, -1);
+  n.param(ns + "/positive_button", mapping.positive_button, -1);
+  n.param(ns + "/negative_button", mapping.negative_button, -1);
+  n.param(ns + "/deadzone", mapping.deadzone, 0.);
+  n.param(ns + "/exponent", mapping.exponent, 1.);
+  n.param(ns + "/scale", mapping.scale, 1.);
+
+  const std::string error = validateJoyInputMapping(mapping);
+  if (!error.empty())
+  {
+    ROS_WARN_STREAM_NAMED(NODE_NAME, "Mapping '" << ns << "': " << error << " Check yaml file.");
+    return false;
+  }
+  return true;
+}
+
+bool readJoyMapping(const ros::NodeHandle& n, JoyMapping& mapping)
+{
+  for (std::size_t i = 0; i < mapping.twist.size(); ++i)
+  {
+    if (!readJoyInputMapping(n, "twist/" + TWIST_COMPONENT_NAMES[i], mapping.twist[i]))
+      return false;
+  }
+
+  n.param("joint_names", mapping.joint_names, std::vector<std::string>());
+  mapping.joints.resize(mapping.joint_names.size());
+  for (std::size_t i = 0; i < mapping.joint_names.size(); ++i)
+  {
+    if (!readJoyInputMapping(n, "joints/" + mapping.joint_names[i], mapping.joints[i]))
+      return false;
+  }
+  return true;
+}
+
+void applyJoyMapping(const JoyMapping& mapping, const std::vector<float>& axes, const std::vector<int32_t>& buttons,
+                     std::array<double, 6>& twist, std::vector<double>& joint_deltas)
+{
+  for (std::size_t i = 0; i < twist.size(); ++i)
+    twist[i] = mapping.twist[i].apply(axes, buttons);
+
+  joint_deltas.resize(mapping.joints.size());
+  for (std::size_t i = 0; i < mapping.joints.size(); ++i)
+    joint_deltas[i] = mapping.joints[i].apply(axes, buttons);
+}
+}  // namespace jog_arm
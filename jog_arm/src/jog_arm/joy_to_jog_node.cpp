@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : joy_to_jog_node.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Converts sensor_msgs/Joy from any joystick or spacemouse into jogging
+// commands. The mapping is read from the node's private namespace. See
+// config/joy_to_jog/ for examples.
+
+#include <geometry_msgs/TwistStamped.h>
+#include <jog_arm/joy_mapping.h>
+#include <jog_msgs/JogJoint.h>
+#include <sensor_msgs/Joy.h>
+#include <algorithm>
+
+static const char* const NODE_NAME = "joy_to_jog";
+
+namespace jog_arm
+{
+class JoyToJog
+{
+public:
+  explicit JoyToJog(const ros::NodeHandle& private_n) : private_n_(private_n)
+  {
+  }
+
+  // Read parameters and start the subs & pubs. False if the parameters are invalid.
+  bool start()
+  {
+    if (!readJoyMapping(private_n_, mapping_))
+      return false;
+    joint_deltas_.assign(mapping_.joints.size(), 0.);
+    published_joint_deltas_ = joint_deltas_;
+
+    std::string cartesian_command_out_topic, joint_command_out_topic;
+    private_n_.param<std::string>("cartesian_command_out_topic", cartesian_command_out_topic,
+                                  "jog_arm_server/delta_jog_cmds");
+    private_n_.param<std::string>("joint_command_out_topic", joint_command_out_topic,
+                                  "jog_arm_server/joint_delta_jog_cmds");
+    private_n_.param("publish_period", publish_period_, 0.008);
+    private_n_.param("heartbeat_period", heartbeat_period_, 0.5);
+    if (publish_period_ <= 0. || heartbeat_period_ < publish_period_)
+    {
+      ROS_WARN_NAMED(NODE_NAME, "Parameter 'publish_period' should be greater than zero, and 'heartbeat_period' "
+                                "should not be less than 'publish_period'. Check yaml file.");
+      return false;
+    }
+
+    twist_pub_ = n_.advertise<geometry_msgs::TwistStamped>(cartesian_command_out_topic, 1);
+    if (!mapping_.joints.empty())
+      joint_delta_pub_ = n_.advertise<jog_msgs::JogJoint>(joint_command_out_topic, 1);
+
+    // Joy msgs only update the commands. This timer publishes them at a steady rate.
+    publish_timer_ = n_.createTimer(ros::Duration(publish_period_), &JoyToJog::publishCB, this);
+
+    joy_sub_ = n_.subscribe("joy", 1, &JoyToJog::joyCB, this);
+    return true;
+  }
+
+private:
+  // Keep only the latest input. Bursts of joy msgs are combined into the next publish cycle.
+  void joyCB(const sensor_msgs::Joy::ConstPtr& msg)
+  {
+    applyJoyMapping(mapping_, msg->axes, msg->buttons, twist_, joint_deltas_);
+  }
+
+  // Publish a command that changed since the last cycle. Repeat an unchanged, non-zero command
+  // every heartbeat_period, so the jog server doesn't consider it stale. Both commands of a cycle
+  // get the same stamp.
+  void publishCB(const ros::TimerEvent&)
+  {
+    const ros::Time now = ros::Time::now();
+    const ros::Duration heartbeat_period(heartbeat_period_);
+
+    if (twist_ != published_twist_ || (!isZero(twist_) && now - twist_publish_time_ >= heartbeat_period))
+    {
+      geometry_msgs::TwistStamped twist;
+      twist.header.stamp = now;
+      twist.twist.linear.x = twist_[0];
+      twist.twist.linear.y = twist_[1];
+      twist.twist.linear.z = twist_[2];
+      twist.twist.angular.x = twist_[3];
+      twist.twist.angular.y = twist_[4];
+      twist.twist.angular.z = twist_[5];
+      twist_pub_.publish(twist);
+      published_twist_ = twist_;
+      twist_publish_time_ = now;
+    }
+
+    if (!mapping_.joints.empty() &&
+        (joint_deltas_ != published_joint_deltas_ ||
+         (!isZero(joint_deltas_) && now - joint_deltas_publish_time_ >= heartbeat_period)))
+    {
+      jog_msgs::JogJoint joint_deltas;
+      joint_deltas.header.stamp = now;
+      joint_deltas.joint_names = mapping_.joint_names;
+      joint_deltas.deltas = joint_deltas_;
+      joint_delta_pub_.publish(joint_deltas);
+      published_joint_deltas_ = joint_deltas_;
+      joint_deltas_publish_time_ = now;
+    }
+  }
+
+  template <class Container>
+  static bool isZero(const Container& values)
+  {
+    return std::all_of(values.begin(), values.end(), [](double value) { return value == 0.; });
+  }
+
+  ros::NodeHandle n_, private_n_;
+  ros::Subscriber joy_sub_;
+  ros::Publisher twist_pub_, joint_delta_pub_;
+
+  JoyMapping mapping_;
+
+  // The latest commands, and the last ones that were published
+  std::array<double, 6> twist_ = { { 0., 0., 0., 0., 0., 0. } };
+  std::array<double, 6> published_twist_ = { { 0., 0., 0., 0., 0., 0. } };
+  std::vector<double> joint_deltas_, published_joint_deltas_;
+
+  // [s] publish_period should match the jog server's
+  double publish_period_, heartbeat_period_;
+  ros::Timer publish_timer_;
+  ros::Time twist_publish_time_, joint_deltas_publish_time_;
+};
+}  // namespace jog_arm
+
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, NODE_NAME);
+
+  jog_arm::JoyToJog joy_to_jog(ros::NodeHandle("~"));
+  if (!joy_to_jog.start())
+    exit(EXIT_FAILURE);
+
+  ros::spin();
+
+  return 0;
+}
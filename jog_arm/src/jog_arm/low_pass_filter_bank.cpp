@@ -0,0 +1,272 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : low_pass_filter_bank.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Multi-channel low-pass filter for the jogging pipeline.
+
+#include <jog_arm/low_pass_filter_bank.h>
+#include <cmath>
+
+namespace jog_arm
+{
+bool parseFilterType(const std::string& name, FilterType& type)
+{
+  if (name == "butterworth")
+    type = FilterType::BUTTERWORTH;
+  else if (name == "critically_damped")
+    type = FilterType::CRITICALLY_DAMPED;
+  else if (name == "one_euro")
+    type = FilterType::ONE_EURO;
+  else
+    return false;
+
+  return true;
+}
+
+std::string LowPassFilterBank::validate(const FilterSpec& spec)
+{
+  if (spec.sample_period <= 0.)
+    return "The filter sample period must be greater than zero.";
+  if (spec.cutoff_frequency <= 0.)
+    return "The filter cutoff frequency must be greater than zero.";
+  if (spec.type != FilterType::ONE_EURO && spec.cutoff_frequency >= 0.5 / spec.sample_period)
+    return "The filter cutoff frequency must be below the Nyquist frequency, 0.5/sample_period.";
+  if (spec.type != FilterType::ONE_EURO && (spec.order < 1 || spec.order > 4))
+    return "The filter order must be between 1 and 4.";
+  if (spec.type == FilterType::ONE_EURO && (spec.one_euro_beta < 0. || spec.one_euro_derivative_cutoff <= 0.))
+    return "one_euro_beta must be non-negative and one_euro_derivative_cutoff must be greater than zero.";
+
+  return "";
+}
+
+double LowPassFilterBank::cutoffFromCoefficient(const double low_pass_filter_coeff, const double sample_period)
+{
+  // The old filter was a bilinear-transformed Butterworth with coeff = 1/tan(pi*fc*T)
+  return std::atan(1. / low_pass_filter_coeff) / (M_PI * sample_period);
+}
+
+LowPassFilterBank::LowPassFilterBank(const std::size_t num_channels, const FilterSpec& spec)
+  : spec_(spec)
+  , prev_filtered_msrmts_(Eigen::ArrayXd::Zero(num_channels))
+  , prev_filtered_derivative_(Eigen::ArrayXd::Zero(num_channels))
+  , work_(Eigen::ArrayXd::Zero(num_channels))
+{
+  designSections();
+}
+
+void LowPassFilterBank::setSpec(const FilterSpec& spec)
+{
+  const FilterType previous_type = spec_.type;
+  std::vector<Section> previous_sections;
+  previous_sections.swap(sections_);
+
+  spec_ = spec;
+  designSections();
+
+  if (spec_.type == previous_type && sections_.size() == previous_sections.size())
+  {
+    // Only the coefficients changed. Every section has unity DC gain, so the history is still valid.
+    for (std::size_t i = 0; i < sections_.size(); ++i)
+    {
+      sections_[i].prev_msrmts_1.swap(previous_sections[i].prev_msrmts_1);
+      sections_[i].prev_msrmts_2.swap(previous_sections[i].prev_msrmts_2);
+      sections_[i].prev_filtered_msrmts_1.swap(previous_sections[i].prev_filtered_msrmts_1);
+      sections_[i].prev_filtered_msrmts_2.swap(previous_sections[i].prev_filtered_msrmts_2);
+    }
+    return;
+  }
+
+  // work_ holds the last output
+  const Eigen::ArrayXd last_output = work_;
+  reset(last_output.data());
+}
+
+void LowPassFilterBank::designSections()
+{
+  switch (spec_.type)
+  {
+    case FilterType::BUTTERWORTH:
+    {
+      // Pole pairs of an analog Butterworth prototype, plus one real pole if the order is odd
+      for (int k = 0; k < spec_.order / 2; ++k)
+      {
+        const double theta = M_PI * (2. * k + 1.) / (2. * spec_.order);
+        addSecondOrderSection(spec_.cutoff_frequency, 1. / (2. * std::sin(theta)));
+      }
+      if (spec_.order % 2)
+        addFirstOrderSection(spec_.cutoff_frequency);
+      break;
+    }
+    case FilterType::CRITICALLY_DAMPED:
+    {
+      // Identical real poles. Spread them so the cascade is still -3dB at the cutoff.
+      // The spread is done on the pre-warped frequency, so it is exact after the bilinear transform.
+      const double warped_cutoff = std::tan(M_PI * spec_.cutoff_frequency * spec_.sample_period);
+      const double section_cutoff =
+          std::atan(warped_cutoff / std::sqrt(std::pow(2., 1. / spec_.order) - 1.)) / (M_PI * spec_.sample_period);
+      for (int k = 0; k < spec_.order; ++k)
+        addFirstOrderSection(section_cutoff);
+      break;
+    }
+    case FilterType::ONE_EURO:
+      break;
+  }
+}
+
+// Bilinear transform with frequency pre-warping, so the cutoff lands exactly where requested
+void LowPassFilterBank::addFirstOrderSection(const double cutoff_frequency)
+{
+  const double k = std::tan(M_PI * cutoff_frequency * spec_.sample_period);
+
+  Section section;
+  section.b0 = k / (1. + k);
+  section.b1 = section.b0;
+  section.b2 = 0.;
+  section.a1 = (k - 1.) / (k + 1.);
+  section.a2 = 0.;
+  addSection(section);
+}
+
+void LowPassFilterBank::addSecondOrderSection(const double cutoff_frequency, const double q)
+{
+  const double k = std::tan(M_PI * cutoff_frequency * spec_.sample_period);
+  const double norm = 1. / (1. + k / q + k * k);
+
+  Section section;
+  section.b0 = k * k * norm;
+  section.b1 = 2. * section.b0;
+  section.b2 = section.b0;
+  section.a1 = 2. * (k * k - 1.) * norm;
+  section.a2 = (1. - k / q + k * k) * norm;
+  addSection(section);
+}
+
+void LowPassFilterBank::addSection(Section& section)
+{
+  // Start at rest, like the filter output
+  section.prev_msrmts_1 = Eigen::ArrayXd::Zero(work_.size());
+  section.prev_msrmts_2 = section.prev_msrmts_1;
+  section.prev_filtered_msrmts_1 = section.prev_msrmts_1;
+  section.prev_filtered_msrmts_2 = section.prev_msrmts_1;
+  sections_.push_back(section);
+}
+
+void LowPassFilterBank::reset(const double data)
+{
+  work_.setConstant(data);
+  reset(work_.data());
+}
+
+void LowPassFilterBank::reset(const double* data)
+{
+  const Eigen::Map<const Eigen::ArrayXd> steady_state(data, work_.size());
+
+  // Every section has unity DC gain, so the same value is a steady state throughout the cascade
+  for (Section& section : sections_)
+  {
+    section.prev_msrmts_1 = steady_state;
+    section.prev_msrmts_2 = steady_state;
+    section.prev_filtered_msrmts_1 = steady_state;
+    section.prev_filtered_msrmts_2 = steady_state;
+  }
+
+  if (spec_.type == FilterType::ONE_EURO)
+  {
+    prev_filtered_msrmts_ = steady_state;
+    prev_filtered_derivative_.setZero();
+  }
+}
+
+void LowPassFilterBank::filter(const Eigen::Ref<const Eigen::ArrayXd>& input, Eigen::Ref<Eigen::ArrayXd> output)
+{
+  // Copy first, in case output aliases input
+  work_ = input;
+
+  if (spec_.type == FilterType::ONE_EURO)
+    oneEuroFilter(work_);
+
+  for (Section& s : sections_)
+  {
+    // Overwrite the oldest filtered measurement with the new one.
+    // The expression is coefficient-wise, so reading and writing the same array is safe.
+    s.prev_filtered_msrmts_2.swap(s.prev_filtered_msrmts_1);
+    s.prev_filtered_msrmts_1 = s.b0 * work_ + s.b1 * s.prev_msrmts_1 + s.b2 * s.prev_msrmts_2 -
+                               s.a1 * s.prev_filtered_msrmts_2 - s.a2 * s.prev_filtered_msrmts_1;
+
+    // Push in the new measurement
+    s.prev_msrmts_2.swap(s.prev_msrmts_1);
+    s.prev_msrmts_1 = work_;
+
+    // The output of this section is the input to the next
+    work_ = s.prev_filtered_msrmts_1;
+  }
+
+  output = work_;
+}
+
+// Casiez et al., "1 Euro Filter: A Simple Speed-based Low-pass Filter for Noisy Input in Interactive Systems"
+// A first-order filter whose cutoff rises with the rate of change, so it smooths slow motion but lags little
+// on fast motion.
+void LowPassFilterBank::oneEuroFilter(Eigen::ArrayXd& data)
+{
+  const double dt = spec_.sample_period;
+
+  // Smoothing factor of a first-order filter with time constant 1/(2*pi*fc)
+  const double derivative_alpha = 1. / (1. + 1. / (2. * M_PI * spec_.one_euro_derivative_cutoff * dt));
+  prev_filtered_derivative_ +=
+      derivative_alpha * ((data - prev_filtered_msrmts_) / dt - prev_filtered_derivative_);
+
+  // The adaptive cutoff is spec_.cutoff_frequency + beta*|derivative|
+  prev_filtered_msrmts_ +=
+      (data - prev_filtered_msrmts_) /
+      (1. + 1. / (2. * M_PI * dt * (spec_.cutoff_frequency + spec_.one_euro_beta * prev_filtered_derivative_.abs())));
+
+  data = prev_filtered_msrmts_;
+}
+
+void LowPassFilterBank::filter(double* data)
+{
+  Eigen::Map<Eigen::ArrayXd> channels(data, work_.size());
+  filter(channels, channels);
+}
+
+double LowPassFilterBank::filter(double new_msrmt)
+{
+  filter(&new_msrmt);
+  return new_msrmt;
+}
+}  // namespace jog_arm
@@ -0,0 +1,361 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : periodic_task_executor.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Runs periodic tasks on a small pool of worker threads.
+
+#include <jog_arm/periodic_task_executor.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <limits>
+
+namespace jog_arm
+{
+static double monotonicNow()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + 1e-9 * now.tv_nsec;
+}
+
+static timespec toTimespec(const double time)
+{
+  timespec result;
+  result.tv_sec = static_cast<time_t>(time);
+  result.tv_nsec = static_cast<long>((time - result.tv_sec) * 1e9);
+  return result;
+}
+
+PeriodicTaskExecutor::PeriodicTaskExecutor(const std::size_t num_threads) : num_threads_(num_threads)
+{
+  if (num_threads_ == 0)
+    num_threads_ = std::max(1l, sysconf(_SC_NPROCESSORS_ONLN));
+
+  pthread_mutex_init(&mutex_, nullptr);
+  pthread_cond_init(&work_available_, nullptr);
+  pthread_cond_init(&task_finished_, nullptr);
+
+  // The dispatcher sleeps until the next release, which must not jump with the wall clock
+  pthread_condattr_t dispatch_wakeup_attributes;
+  pthread_condattr_init(&dispatch_wakeup_attributes);
+  pthread_condattr_setclock(&dispatch_wakeup_attributes, CLOCK_MONOTONIC);
+  pthread_cond_init(&dispatch_wakeup_, &dispatch_wakeup_attributes);
+  pthread_condattr_destroy(&dispatch_wakeup_attributes);
+}
+
+PeriodicTaskExecutor::~PeriodicTaskExecutor()
+{
+  stop();
+
+  pthread_cond_destroy(&dispatch_wakeup_);
+  pthread_cond_destroy(&task_finished_);
+  pthread_cond_destroy(&work_available_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+std::size_t PeriodicTaskExecutor::addTask(const std::string& name, const double period, const double deadline,
+                                          const int priority, TaskFunction function)
+{
+  pthread_mutex_lock(&mutex_);
+
+  const std::size_t task_id = tasks_.size();
+  tasks_.emplace_back();
+  Task& task = tasks_.back();
+  task.statistics.name = name;
+  task.period = period;
+  task.deadline = (deadline > 0) ? deadline : period;
+  task.priority = priority;
+  task.function = function;
+  task.next_release = monotonicNow();
+  task.worker = task_id % num_threads_;
+
+  pthread_cond_signal(&dispatch_wakeup_);
+  pthread_mutex_unlock(&mutex_);
+
+  return task_id;
+}
+
+void PeriodicTaskExecutor::setPeriod(const std::size_t task_id, const double period, const double deadline)
+{
+  pthread_mutex_lock(&mutex_);
+  if (task_id < tasks_.size())
+  {
+    Task& task = tasks_[task_id];
+    task.period = period;
+    task.deadline = (deadline > 0) ? deadline : period;
+  }
+  pthread_cond_signal(&dispatch_wakeup_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+void PeriodicTaskExecutor::removeTask(const std::size_t task_id)
+{
+  pthread_mutex_lock(&mutex_);
+  if (task_id < tasks_.size())
+  {
+    Task& task = tasks_[task_id];
+    task.removed = true;
+    while (task.running)
+      pthread_cond_wait(&task_finished_, &mutex_);
+  }
+  pthread_mutex_unlock(&mutex_);
+}
+
+void PeriodicTaskExecutor::pauseTask(const std::size_t task_id)
+{
+  pthread_mutex_lock(&mutex_);
+  if (task_id < tasks_.size())
+    tasks_[task_id].paused = true;
+  pthread_mutex_unlock(&mutex_);
+}
+
+void PeriodicTaskExecutor::resumeTask(const std::size_t task_id)
+{
+  pthread_mutex_lock(&mutex_);
+  if (task_id < tasks_.size() && tasks_[task_id].paused)
+  {
+    tasks_[task_id].paused = false;
+    tasks_[task_id].next_release = monotonicNow();
+    pthread_cond_signal(&dispatch_wakeup_);
+  }
+  pthread_mutex_unlock(&mutex_);
+}
+
+bool PeriodicTaskExecutor::start()
+{
+  if (started_)
+    return true;
+
+  pthread_mutex_lock(&mutex_);
+  stop_requested_ = false;
+  pthread_mutex_unlock(&mutex_);
+  started_ = true;
+
+  worker_args_.resize(num_threads_);
+  for (std::size_t worker = 0; worker < num_threads_; ++worker)
+  {
+    worker_args_[worker].executor = this;
+    worker_args_[worker].worker = worker;
+
+    pthread_t thread;
+    if (pthread_create(&thread, nullptr, &PeriodicTaskExecutor::workerThread, &worker_args_[worker]))
+    {
+      stop();
+      return false;
+    }
+    workers_.push_back(thread);
+  }
+
+  if (pthread_create(&dispatcher_, nullptr, &PeriodicTaskExecutor::dispatchThread, this))
+  {
+    stop();
+    return false;
+  }
+  dispatcher_started_ = true;
+
+  return true;
+}
+
+void PeriodicTaskExecutor::stop()
+{
+  if (!started_)
+    return;
+
+  pthread_mutex_lock(&mutex_);
+  stop_requested_ = true;
+  pthread_cond_broadcast(&work_available_);
+  pthread_cond_signal(&dispatch_wakeup_);
+  pthread_mutex_unlock(&mutex_);
+
+  if (dispatcher_started_)
+    (void)pthread_join(dispatcher_, nullptr);
+  dispatcher_started_ = false;
+  for (pthread_t& worker : workers_)
+    (void)pthread_join(worker, nullptr);
+  workers_.clear();
+
+  // Drop the jobs that never ran. They are released again after a restart.
+  pthread_mutex_lock(&mutex_);
+  ready_jobs_.clear();
+  for (Task& task : tasks_)
+    task.queued = false;
+  pthread_mutex_unlock(&mutex_);
+
+  started_ = false;
+}
+
+PeriodicTaskExecutor::TaskStatistics PeriodicTaskExecutor::getStatistics(const std::size_t task_id) const
+{
+  pthread_mutex_lock(&mutex_);
+  TaskStatistics statistics;
+  if (task_id < tasks_.size())
+    statistics = tasks_[task_id].statistics;
+  pthread_mutex_unlock(&mutex_);
+  return statistics;
+}
+
+void* PeriodicTaskExecutor::dispatchThread(void* executor)
+{
+  static_cast<PeriodicTaskExecutor*>(executor)->dispatch();
+  return nullptr;
+}
+
+void* PeriodicTaskExecutor::workerThread(void* args)
+{
+  const WorkerArgs& worker_args = *static_cast<WorkerArgs*>(args);
+  worker_args.executor->work(worker_args.worker);
+  return nullptr;
+}
+
+void PeriodicTaskExecutor::dispatch()
+{
+  pthread_mutex_lock(&mutex_);
+  while (!stop_requested_)
+  {
+    const double next_release = releaseDueTasks(monotonicNow());
+
+    if (next_release == std::numeric_limits<double>::infinity())
+    {
+      pthread_cond_wait(&dispatch_wakeup_, &mutex_);
+    }
+    else
+    {
+      const timespec wakeup = toTimespec(next_release);
+      pthread_cond_timedwait(&dispatch_wakeup_, &mutex_, &wakeup);
+    }
+  }
+  pthread_mutex_unlock(&mutex_);
+}
+
+double PeriodicTaskExecutor::releaseDueTasks(const double now)
+{
+  double next_release = std::numeric_limits<double>::infinity();
+  bool released = false;
+
+  for (std::size_t task_id = 0; task_id < tasks_.size(); ++task_id)
+  {
+    Task& task = tasks_[task_id];
+    if (task.removed || task.paused)
+      continue;
+
+    if (now >= task.next_release)
+    {
+      if (task.queued || task.running)
+      {
+        ++task.statistics.overruns;
+      }
+      else
+      {
+        Job job;
+        job.task_id = task_id;
+        job.priority = task.priority;
+        job.absolute_deadline = task.next_release + task.deadline;
+        job.worker = task.worker;
+        ready_jobs_.push_back(job);
+        task.queued = true;
+        released = true;
+      }
+
+      task.next_release += task.period;
+      // Fell behind. Don't release a burst of jobs to catch up.
+      if (task.next_release <= now)
+        task.next_release = now + task.period;
+    }
+
+    next_release = std::min(next_release, task.next_release);
+  }
+
+  if (released)
+    pthread_cond_broadcast(&work_available_);
+
+  return next_release;
+}
+
+void PeriodicTaskExecutor::work(const std::size_t worker)
+{
+  pthread_mutex_lock(&mutex_);
+  while (true)
+  {
+    while (!stop_requested_ && ready_jobs_.empty())
+      pthread_cond_wait(&work_available_, &mutex_);
+    if (stop_requested_)
+      break;
+
+    const Job job = popJob(worker);
+    Task& task = tasks_[job.task_id];
+    task.queued = false;
+    if (task.removed)
+      continue;
+    task.running = true;
+    task.worker = worker;
+    pthread_mutex_unlock(&mutex_);
+
+    const double start = monotonicNow();
+    task.function();
+    const double finish = monotonicNow();
+
+    pthread_mutex_lock(&mutex_);
+    task.running = false;
+    ++task.statistics.runs;
+    task.statistics.total_duration += finish - start;
+    task.statistics.max_duration = std::max(task.statistics.max_duration, finish - start);
+    if (finish > job.absolute_deadline)
+      ++task.statistics.overruns;
+    pthread_cond_broadcast(&task_finished_);
+  }
+  pthread_mutex_unlock(&mutex_);
+}
+
+PeriodicTaskExecutor::Job PeriodicTaskExecutor::popJob(const std::size_t worker)
+{
+  // Higher priority first, then the earliest deadline, then the jobs this worker ran last
+  auto more_urgent = [worker](const Job& a, const Job& b) {
+    if (a.priority != b.priority)
+      return a.priority > b.priority;
+    if (a.absolute_deadline != b.absolute_deadline)
+      return a.absolute_deadline < b.absolute_deadline;
+    return a.worker == worker && b.worker != worker;
+  };
+
+  std::vector<Job>::iterator most_urgent = std::min_element(ready_jobs_.begin(), ready_jobs_.end(), more_urgent);
+  const Job job = *most_urgent;
+  *most_urgent = ready_jobs_.back();
+  ready_jobs_.pop_back();
+  return job;
+}
+}  // namespace jog_arm
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : robot_model_cache.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <jog_arm/robot_model_cache.h>
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace
+{
+const std::string NODE_NAME = "jog_arm_server";
+
+struct CachedModel
+{
+  std::weak_ptr<robot_model_loader::RobotModelLoader> loader;
+  bool kinematics_solvers_loaded;
+};
+
+// Keyed by the URDF and SRDF themselves. A hash could collide and hand out another robot's model.
+typedef std::pair<std::string, std::string> CacheKey;
+std::mutex cache_mutex;
+std::map<CacheKey, CachedModel> cache;
+}  // namespace
+
+namespace jog_arm
+{
+std::shared_ptr<robot_model_loader::RobotModelLoader>
+loadRobotModel(const ros::NodeHandle& n, const std::string& robot_description, bool load_kinematics_solvers)
+{
+  // Read the descriptions once. They are both the cache key and the input to the loader.
+  std::string urdf_param, urdf_string, srdf_string;
+  if (!n.searchParam(robot_description, urdf_param) || !n.getParam(urdf_param, urdf_string))
+  {
+    ROS_ERROR_STREAM_NAMED(NODE_NAME, "Robot description '" << robot_description << "' is not on the parameter server");
+    return nullptr;
+  }
+  n.getParam(urdf_param + "_semantic", srdf_string);
+
+  CacheKey key(urdf_string, srdf_string);
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+
+  // A model with kinematics solvers also serves callers that don't need them
+  std::map<CacheKey, CachedModel>::iterator cached = cache.find(key);
+  if (cached != cache.end() && (cached->second.kinematics_solvers_loaded || !load_kinematics_solvers))
+  {
+    std::shared_ptr<robot_model_loader::RobotModelLoader> loader = cached->second.loader.lock();
+    if (loader)
+      return loader;
+  }
+
+  robot_model_loader::RobotModelLoader::Options options(urdf_param);
+  options.urdf_string_ = urdf_string;
+  options.srdf_string_ = srdf_string;
+  options.load_kinematics_solvers_ = load_kinematics_solvers;
+  std::shared_ptr<robot_model_loader::RobotModelLoader> loader =
+      std::make_shared<robot_model_loader::RobotModelLoader>(options);
+  if (!loader->getModel())
+  {
+    ROS_ERROR_STREAM_NAMED(NODE_NAME, "Parsing robot description '" << robot_description << "' failed");
+    return nullptr;
+  }
+
+  // Forget the models nobody uses any more, so their descriptions aren't kept around
+  for (std::map<CacheKey, CachedModel>::iterator entry = cache.begin(); entry != cache.end();)
+  {
+    if (entry->second.loader.expired())
+      entry = cache.erase(entry);
+    else
+      ++entry;
+  }
+
+  cache[std::move(key)] = CachedModel{ loader, load_kinematics_solvers };
+  return loader;
+}
+}  // namespace jog_arm
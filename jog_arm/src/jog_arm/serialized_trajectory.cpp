@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : serialized_trajectory.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Outgoing trajectories, kept in their wire format between cycles.
+
+#include <jog_arm/serialized_trajectory.h>
+
+namespace jog_arm
+{
+// Header.seq comes first, then Header.stamp
+static const std::size_t SEQ_OFFSET = 0;
+static const std::size_t STAMP_OFFSET = 4;
+static const std::size_t FRAME_ID_OFFSET = 12;
+
+void SerializedTrajectory::update(const JogTrajectory& trajectory)
+{
+  if (!matchesLayout(trajectory))
+  {
+    serialize(trajectory);
+    return;
+  }
+
+  write(SEQ_OFFSET, trajectory.header.seq);
+  write(STAMP_OFFSET, trajectory.header.stamp.sec);
+  write(STAMP_OFFSET + 4, trajectory.header.stamp.nsec);
+  for (std::size_t i = 0; i < trajectory.points.size(); ++i)
+  {
+    const JogTrajectoryPoint& point = trajectory.points[i];
+    const PointOffsets& offsets = point_offsets_[i];
+    writeArray(offsets.positions, point.positions);
+    writeArray(offsets.velocities, point.velocities);
+    writeArray(offsets.accelerations, point.accelerations);
+    writeArray(offsets.effort, point.effort);
+    write(offsets.time_from_start, point.time_from_start.sec);
+    write(offsets.time_from_start + 4, point.time_from_start.nsec);
+  }
+}
+
+void SerializedTrajectory::serialize(const JogTrajectory& trajectory)
+{
+  buffer_.resize(ros::serialization::serializationLength(trajectory));
+  ros::serialization::OStream stream(buffer_.data(), static_cast<uint32_t>(buffer_.size()));
+  ros::serialization::serialize(stream, trajectory);
+
+  // Skip over the header and the joint names to the points
+  std::size_t offset = FRAME_ID_OFFSET + 4 + trajectory.header.frame_id.size() + 4;
+  for (const auto& name : trajectory.joint_names)
+    offset += 4 + name.size();
+  offset += 4;
+
+  point_offsets_.resize(trajectory.points.size());
+  for (std::size_t i = 0; i < trajectory.points.size(); ++i)
+  {
+    const JogTrajectoryPoint& point = trajectory.points[i];
+    PointOffsets& offsets = point_offsets_[i];
+    offsets.positions = offset + 4;
+    offset = offsets.positions + point.positions.size() * sizeof(double);
+    offsets.velocities = offset + 4;
+    offset = offsets.velocities + point.velocities.size() * sizeof(double);
+    offsets.accelerations = offset + 4;
+    offset = offsets.accelerations + point.accelerations.size() * sizeof(double);
+    offsets.effort = offset + 4;
+    offset = offsets.effort + point.effort.size() * sizeof(double);
+    offsets.time_from_start = offset;
+    offset += 8;
+  }
+}
+
+bool SerializedTrajectory::matchesLayout(const JogTrajectory& trajectory) const
+{
+  if (buffer_.empty() || trajectory.points.size() != point_offsets_.size())
+    return false;
+
+  std::size_t offset = FRAME_ID_OFFSET;
+  if (!matchesString(trajectory.header.frame_id, offset))
+    return false;
+
+  if (readLength(offset) != trajectory.joint_names.size())
+    return false;
+  offset += 4;
+  for (const auto& name : trajectory.joint_names)
+  {
+    if (!matchesString(name, offset))
+      return false;
+  }
+
+  for (std::size_t i = 0; i < trajectory.points.size(); ++i)
+  {
+    const JogTrajectoryPoint& point = trajectory.points[i];
+    const PointOffsets& offsets = point_offsets_[i];
+    if (readLength(offsets.positions - 4) != point.positions.size() ||
+        readLength(offsets.velocities - 4) != point.velocities.size() ||
+        readLength(offsets.accelerations - 4) != point.accelerations.size() ||
+        readLength(offsets.effort - 4) != point.effort.size())
+      return false;
+  }
+
+  return true;
+}
+
+uint32_t SerializedTrajectory::readLength(const std::size_t offset) const
+{
+  uint32_t length;
+  std::memcpy(&length, &buffer_[offset], sizeof(length));
+  return length;
+}
+}  // namespace jog_arm
@@ -0,0 +1,186 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : cycle_arena_test.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Unit tests for the cycle arena and its allocator.
+
+#include <gtest/gtest.h>
+#include <jog_arm/cycle_arena.h>
+#include <cstdint>
+#include <vector>
+
+namespace jog_arm
+{
+namespace
+{
+bool isAligned(const void* p, std::size_t alignment)
+{
+  return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+TEST(CycleArena, AllocationsAreBumpedAndAligned)
+{
+  CycleArena arena(256);
+  char* a = static_cast<char*>(arena.allocate(3, 1));
+  char* b = static_cast<char*>(arena.allocate(8, 8));
+  char* c = static_cast<char*>(arena.allocate(1, 1));
+
+  EXPECT_TRUE(isAligned(b, 8));
+  EXPECT_GE(b, a + 3);
+  EXPECT_LT(b, a + 3 + 8);
+  EXPECT_EQ(c, b + 8);
+  EXPECT_EQ(arena.capacity(), 256u);
+}
+
+TEST(CycleArena, ResetReusesTheBlock)
+{
+  CycleArena arena(256);
+  void* first = arena.allocate(100, 8);
+  arena.allocate(100, 8);
+  arena.reset();
+
+  EXPECT_EQ(arena.allocate(100, 8), first);
+  EXPECT_EQ(arena.capacity(), 256u);
+}
+
+TEST(CycleArena, OverflowChainsABlockAndResetMergesIt)
+{
+  CycleArena arena(64);
+  char* first = static_cast<char*>(arena.allocate(48, 8));
+  char* overflow = static_cast<char*>(arena.allocate(48, 8));
+
+  // The first allocation must stay valid, so the overflow comes from a new block
+  EXPECT_TRUE(overflow < first || overflow >= first + 48);
+  EXPECT_TRUE(isAligned(overflow, 8));
+  const std::size_t grown = arena.capacity();
+  EXPECT_GT(grown, 64u);
+
+  arena.reset();
+  EXPECT_EQ(arena.capacity(), grown);
+
+  // The same cycle now fits in the merged block without growing
+  char* a = static_cast<char*>(arena.allocate(48, 8));
+  char* b = static_cast<char*>(arena.allocate(48, 8));
+  EXPECT_EQ(b, a + 48);
+  EXPECT_EQ(arena.capacity(), grown);
+}
+
+TEST(CycleArena, AllocationLargerThanTwiceTheBlockFits)
+{
+  CycleArena arena(64);
+  arena.allocate(8, 8);
+  char* big = static_cast<char*>(arena.allocate(1000, 16));
+
+  EXPECT_TRUE(isAligned(big, 16));
+  EXPECT_GE(arena.capacity(), 64u + 1000u);
+  // Touch all of it, so a sanitizer catches a short block
+  for (std::size_t i = 0; i < 1000; ++i)
+    big[i] = static_cast<char>(i);
+}
+
+TEST(ArenaAllocator, WithoutArenaUsesTheHeap)
+{
+  std::vector<double, ArenaAllocator<double>> values;
+  for (int i = 0; i < 100; ++i)
+    values.push_back(i);
+
+  EXPECT_EQ(values.get_allocator().arena(), nullptr);
+  EXPECT_EQ(values[99], 99.);
+}
+
+TEST(ArenaAllocator, VectorGrowsInsideTheArena)
+{
+  CycleArena arena(4096);
+  std::vector<double, ArenaAllocator<double>> values{ ArenaAllocator<double>(&arena) };
+  values.reserve(10);
+  const double* data = values.data();
+  for (int i = 0; i < 10; ++i)
+    values.push_back(i);
+
+  EXPECT_EQ(values.data(), data);
+  EXPECT_EQ(values.get_allocator().arena(), &arena);
+  // Freeing is a no-op, so the next allocation comes after the vector
+  const char* next = static_cast<const char*>(arena.allocate(1, 1));
+  EXPECT_GE(next, reinterpret_cast<const char*>(data + 10));
+}
+
+TEST(ArenaAllocator, CopyConstructionGoesToTheHeap)
+{
+  CycleArena arena(4096);
+  std::vector<double, ArenaAllocator<double>> values({ 1., 2., 3. }, ArenaAllocator<double>(&arena));
+  const std::vector<double, ArenaAllocator<double>> copy(values);
+
+  EXPECT_EQ(copy.get_allocator().arena(), nullptr);
+  EXPECT_EQ(copy, values);
+}
+
+TEST(ArenaAllocator, MoveKeepsTheArena)
+{
+  CycleArena arena(4096);
+  std::vector<double, ArenaAllocator<double>> values({ 1., 2., 3. }, ArenaAllocator<double>(&arena));
+  const double* data = values.data();
+  std::vector<double, ArenaAllocator<double>> moved(std::move(values));
+
+  EXPECT_EQ(moved.get_allocator().arena(), &arena);
+  EXPECT_EQ(moved.data(), data);
+}
+
+TEST(ArenaAllocator, CopyAssignmentKeepsTheTargetAllocator)
+{
+  CycleArena arena(4096);
+  std::vector<double, ArenaAllocator<double>> in_arena({ 1., 2., 3. }, ArenaAllocator<double>(&arena));
+  std::vector<double, ArenaAllocator<double>> on_heap;
+  on_heap = in_arena;
+
+  EXPECT_EQ(on_heap.get_allocator().arena(), nullptr);
+  EXPECT_EQ(on_heap, in_arena);
+}
+
+TEST(ArenaAllocator, ReboundAllocatorsCompareByArena)
+{
+  CycleArena arena, other_arena;
+  const ArenaAllocator<void> message_allocator(&arena);
+  const ArenaAllocator<double> doubles(message_allocator);
+  const ArenaAllocator<int> ints(&arena);
+
+  EXPECT_EQ(doubles.arena(), &arena);
+  EXPECT_TRUE(doubles == ints);
+  EXPECT_TRUE(doubles != ArenaAllocator<int>(&other_arena));
+  EXPECT_TRUE(ArenaAllocator<int>() == ArenaAllocator<double>());
+}
+}  // namespace
+}  // namespace jog_arm
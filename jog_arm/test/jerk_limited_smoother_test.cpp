@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : jerk_limited_smoother_test.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Unit tests for JerkLimitedSmoother.
+
+#include <gtest/gtest.h>
+#include <jog_arm/jerk_limited_smoother.h>
+#include <cmath>
+
+namespace jog_arm
+{
+namespace
+{
+const double SAMPLE_PERIOD = 0.01;
+const double EPSILON = 1e-9;
+
+JerkLimitedSmoother makeSmoother(std::size_t num_joints, double max_velocity, double max_acceleration, double max_jerk)
+{
+  return JerkLimitedSmoother(Eigen::VectorXd::Constant(num_joints, max_velocity),
+                             Eigen::VectorXd::Constant(num_joints, max_acceleration),
+                             Eigen::VectorXd::Constant(num_joints, max_jerk), SAMPLE_PERIOD);
+}
+
+// From rest, the acceleration ramps up by max_jerk*dt per cycle until it hits max_acceleration
+TEST(JerkLimitedSmoother, RampsAccelerationAtMaxJerk)
+{
+  const double max_acceleration = 2., max_jerk = 20.;
+  JerkLimitedSmoother smoother = makeSmoother(1, 10., max_acceleration, max_jerk);
+  const double position = 0.;
+  smoother.reset(&position);
+
+  const Eigen::VectorXd target = Eigen::VectorXd::Constant(1, 5.);
+  for (int i = 1; i <= 15; ++i)
+  {
+    smoother.update(target);
+    EXPECT_NEAR(smoother.acceleration()[0], std::min(i * max_jerk * SAMPLE_PERIOD, max_acceleration), EPSILON)
+        << "cycle " << i;
+  }
+}
+
+// Every step respects the limits and the velocity lands on the target without overshoot
+TEST(JerkLimitedSmoother, ReachesTargetWithinLimits)
+{
+  const double max_velocity = 1.5, max_acceleration = 3., max_jerk = 30.;
+  JerkLimitedSmoother smoother = makeSmoother(2, max_velocity, max_acceleration, max_jerk);
+  const double position[2] = { 0., 1. };
+  smoother.reset(position);
+
+  Eigen::VectorXd target(2);
+  target << 1., -0.4;
+
+  double previous_acceleration[2] = { 0., 0. };
+  for (int i = 0; i < 300; ++i)
+  {
+    smoother.update(target);
+    for (int j = 0; j < 2; ++j)
+    {
+      const double a = smoother.acceleration()[j];
+      EXPECT_LE(std::fabs(a), max_acceleration + EPSILON);
+      EXPECT_LE(std::fabs(a - previous_acceleration[j]), max_jerk * SAMPLE_PERIOD + EPSILON);
+      EXPECT_LE(std::fabs(smoother.velocity()[j]), std::fabs(target[j]) + EPSILON);
+      previous_acceleration[j] = a;
+    }
+  }
+
+  EXPECT_NEAR(smoother.velocity()[0], target[0], EPSILON);
+  EXPECT_NEAR(smoother.velocity()[1], target[1], EPSILON);
+  EXPECT_NEAR(smoother.acceleration()[0], 0., EPSILON);
+}
+
+// Halting is a ramp down to rest, not a step
+TEST(JerkLimitedSmoother, HaltsSmoothly)
+{
+  JerkLimitedSmoother smoother = makeSmoother(1, 2., 3., 30.);
+  const double position = 0.;
+  smoother.reset(&position);
+
+  const Eigen::VectorXd moving = Eigen::VectorXd::Constant(1, 1.);
+  for (int i = 0; i < 200; ++i)
+    smoother.update(moving);
+  ASSERT_FALSE(smoother.isAtRest());
+
+  const Eigen::VectorXd halt = Eigen::VectorXd::Zero(1);
+  smoother.update(halt);
+  EXPECT_GT(smoother.velocity()[0], 0.99);
+
+  for (int i = 0; i < 200; ++i)
+  {
+    const double previous_velocity = smoother.velocity()[0];
+    smoother.update(halt);
+    EXPECT_LE(smoother.velocity()[0], previous_velocity + EPSILON);
+    EXPECT_GE(smoother.velocity()[0], -EPSILON);
+  }
+  EXPECT_TRUE(smoother.isAtRest());
+}
+
+TEST(JerkLimitedSmoother, ClampsToMaxVelocity)
+{
+  const double max_velocity = 0.5;
+  JerkLimitedSmoother smoother = makeSmoother(1, max_velocity, 10., 1000.);
+  const double position = 0.;
+  smoother.reset(&position);
+
+  const Eigen::VectorXd target = Eigen::VectorXd::Constant(1, -3.);
+  for (int i = 0; i < 100; ++i)
+  {
+    smoother.update(target);
+    EXPECT_LE(std::fabs(smoother.velocity()[0]), max_velocity + EPSILON);
+  }
+  EXPECT_NEAR(smoother.velocity()[0], -max_velocity, EPSILON);
+}
+
+// Positions are the trapezoidal integral of the smoothed velocities
+TEST(JerkLimitedSmoother, IntegratesPosition)
+{
+  JerkLimitedSmoother smoother = makeSmoother(1, 2., 3., 30.);
+  const double start = 0.25;
+  smoother.reset(&start);
+
+  double expected_position = start;
+  double previous_velocity = 0.;
+  const Eigen::VectorXd target = Eigen::VectorXd::Constant(1, 0.8);
+  for (int i = 0; i < 100; ++i)
+  {
+    smoother.update(target);
+    expected_position += 0.5 * (previous_velocity + smoother.velocity()[0]) * SAMPLE_PERIOD;
+    previous_velocity = smoother.velocity()[0];
+    EXPECT_NEAR(smoother.position()[0], expected_position, EPSILON);
+  }
+}
+}  // namespace
+}  // namespace jog_arm
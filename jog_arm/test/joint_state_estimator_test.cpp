@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : joint_state_estimator_test.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Unit tests for JointStateEstimator.
+
+#include <gtest/gtest.h>
+#include <jog_arm/joint_state_estimator.h>
+
+namespace jog_arm
+{
+namespace
+{
+const double EPSILON = 1e-9;
+
+TEST(JointStateEstimator, FirstMeasurementInitializes)
+{
+  JointStateEstimator estimator(2, 0.5, 0.2);
+  EXPECT_FALSE(estimator.isInitialized());
+
+  const double position[2] = { 0.1, -0.2 };
+  const double velocity[2] = { 1., 0. };
+  estimator.update(10., position, velocity);
+  ASSERT_TRUE(estimator.isInitialized());
+  EXPECT_EQ(estimator.lastStamp(), 10.);
+
+  double predicted_position[2], predicted_velocity[2];
+  estimator.predict(10., predicted_position, predicted_velocity);
+  EXPECT_NEAR(predicted_position[0], 0.1, EPSILON);
+  EXPECT_NEAR(predicted_position[1], -0.2, EPSILON);
+  EXPECT_NEAR(predicted_velocity[0], 1., EPSILON);
+}
+
+// Positions alone are enough to learn a constant velocity, which is then used to extrapolate
+TEST(JointStateEstimator, LearnsVelocityAndExtrapolates)
+{
+  JointStateEstimator estimator(1, 0.5, 0.2);
+  const double velocity = 0.3, period = 0.01;
+
+  double t = 0.;
+  for (int i = 0; i < 500; ++i)
+  {
+    t = i * period;
+    const double position = velocity * t;
+    estimator.update(t, &position, nullptr);
+  }
+
+  double predicted_position, predicted_velocity;
+  estimator.predict(t + 0.05, &predicted_position, &predicted_velocity);
+  EXPECT_NEAR(predicted_velocity, velocity, 1e-6);
+  EXPECT_NEAR(predicted_position, velocity * (t + 0.05), 1e-6);
+}
+
+TEST(JointStateEstimator, IgnoresOutOfOrderMeasurements)
+{
+  JointStateEstimator estimator(1, 0.5, 0.2);
+  const double first = 1., stale = 5.;
+  estimator.update(2., &first, nullptr);
+  estimator.update(1.9, &stale, nullptr);
+  estimator.update(2., &stale, nullptr);
+
+  double position;
+  estimator.predict(2., &position, nullptr);
+  EXPECT_NEAR(position, first, EPSILON);
+  EXPECT_EQ(estimator.lastStamp(), 2.);
+}
+
+// After a gap in measurements the old estimate is dropped
+TEST(JointStateEstimator, RestartsAfterGap)
+{
+  JointStateEstimator estimator(1, 0.1, 0.1);
+  const double first = 0., second = 3.;
+  estimator.update(0., &first, nullptr);
+  estimator.update(1., &second, nullptr);
+
+  double position, velocity;
+  estimator.predict(1., &position, &velocity);
+  EXPECT_NEAR(position, second, EPSILON);
+  EXPECT_NEAR(velocity, 0., EPSILON);
+}
+
+// Extrapolation never goes backward, and not further than a gap in measurements
+TEST(JointStateEstimator, LimitsExtrapolation)
+{
+  JointStateEstimator estimator(1, 0.5, 0.2);
+  const double position = 0., velocity = 1.;
+  estimator.update(0., &position, &velocity);
+
+  double predicted;
+  estimator.predict(-1., &predicted, nullptr);
+  EXPECT_NEAR(predicted, 0., EPSILON);
+  estimator.predict(100., &predicted, nullptr);
+  EXPECT_NEAR(predicted, 0.5, EPSILON);
+}
+
+// A change in the commanded velocity shows up in the estimate before any measurement does
+TEST(JointStateEstimator, FeedsForwardCommandedVelocity)
+{
+  JointStateEstimator estimator(1, 0.5, 0.2);
+  const double position = 0.;
+  estimator.update(0., &position, nullptr);
+
+  estimator.setCommandedVelocity(Eigen::VectorXd::Constant(1, 0.4));
+  double predicted_position, predicted_velocity;
+  estimator.predict(0.1, &predicted_position, &predicted_velocity);
+  EXPECT_NEAR(predicted_velocity, 0.4, EPSILON);
+  EXPECT_NEAR(predicted_position, 0.04, EPSILON);
+
+  // Only changes are fed forward
+  estimator.setCommandedVelocity(Eigen::VectorXd::Constant(1, 0.4));
+  estimator.predict(0.1, &predicted_position, &predicted_velocity);
+  EXPECT_NEAR(predicted_velocity, 0.4, EPSILON);
+}
+
+TEST(JointStateEstimator, Validate)
+{
+  EXPECT_TRUE(JointStateEstimator::validate(0.5, 0.2).empty());
+  EXPECT_TRUE(JointStateEstimator::validate(1., 0.).empty());
+  EXPECT_FALSE(JointStateEstimator::validate(0., 0.2).empty());
+  EXPECT_FALSE(JointStateEstimator::validate(1.1, 0.2).empty());
+  EXPECT_FALSE(JointStateEstimator::validate(0.5, -0.1).empty());
+  EXPECT_FALSE(JointStateEstimator::validate(0.5, 3.).empty());
+}
+}  // namespace
+}  // namespace jog_arm
@@ -0,0 +1,307 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : joint_state_parser_test.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Unit tests for parsing serialized joint states.
+
+#include <gtest/gtest.h>
+#include <jog_arm/joint_state_parser.h>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+namespace jog_arm
+{
+namespace
+{
+sensor_msgs::JointState makeJointState(const std::vector<std::string>& names)
+{
+  sensor_msgs::JointState msg;
+  msg.header.stamp.sec = 12;
+  msg.header.stamp.nsec = 34;
+  msg.header.frame_id = "base_link";
+  msg.name = names;
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    msg.position.push_back(1. + i);
+    msg.velocity.push_back(-1. - i);
+    msg.effort.push_back(100. + i);
+  }
+  return msg;
+}
+
+std::vector<uint8_t> serialize(const sensor_msgs::JointState& msg)
+{
+  std::vector<uint8_t> buffer(ros::serialization::serializationLength(msg));
+  ros::serialization::OStream stream(buffer.data(), static_cast<uint32_t>(buffer.size()));
+  ros::serialization::serialize(stream, msg);
+  return buffer;
+}
+
+bool parse(JointStateParser& parser, const sensor_msgs::JointState& msg, JointStateFrame& frame)
+{
+  const std::vector<uint8_t> buffer = serialize(msg);
+  return parser.parse(buffer.data(), static_cast<uint32_t>(buffer.size()), frame);
+}
+
+TEST(JointStateParser, ExtractsJointsInFrameOrder)
+{
+  JointStateParser parser;
+  std::vector<std::size_t> indices;
+  ASSERT_TRUE(parser.addJoints({ "c", "a" }, indices));
+  EXPECT_EQ(indices, std::vector<std::size_t>({ 0, 1 }));
+
+  JointStateFrame frame;
+  ASSERT_TRUE(parse(parser, makeJointState({ "a", "b", "c" }), frame));
+  EXPECT_TRUE(frame.complete);
+  EXPECT_TRUE(frame.has_velocity);
+  EXPECT_EQ(frame.num_joints, 2u);
+  EXPECT_EQ(frame.stamp.sec, 12u);
+  EXPECT_EQ(frame.stamp.nsec, 34u);
+  EXPECT_EQ(frame.position[0], 3.);
+  EXPECT_EQ(frame.velocity[0], -3.);
+  EXPECT_EQ(frame.position[1], 1.);
+  EXPECT_EQ(frame.velocity[1], -1.);
+}
+
+TEST(JointStateParser, SharedJointsGetOneFrameIndex)
+{
+  JointStateParser parser;
+  std::vector<std::size_t> first, second;
+  ASSERT_TRUE(parser.addJoints({ "a", "b" }, first));
+  ASSERT_TRUE(parser.addJoints({ "b", "c" }, second));
+
+  EXPECT_EQ(first, std::vector<std::size_t>({ 0, 1 }));
+  EXPECT_EQ(second, std::vector<std::size_t>({ 1, 2 }));
+}
+
+TEST(JointStateParser, TooManyJoints)
+{
+  JointStateParser parser;
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i <= MAX_FRAME_JOINTS; ++i)
+    names.push_back("joint_" + std::to_string(i));
+  std::vector<std::size_t> indices;
+
+  EXPECT_FALSE(parser.addJoints(names, indices));
+}
+
+TEST(JointStateParser, PartialMsgRecordsWhichJointsWereFound)
+{
+  JointStateParser parser;
+  std::vector<std::size_t> left, right;
+  ASSERT_TRUE(parser.addJoints({ "left_1", "left_2" }, left));
+  ASSERT_TRUE(parser.addJoints({ "right_1", "right_2" }, right));
+
+  // Each arm's driver publishes only its own joints
+  JointStateFrame frame;
+  ASSERT_TRUE(parse(parser, makeJointState({ "right_2", "right_1" }), frame));
+  EXPECT_FALSE(frame.complete);
+  EXPECT_FALSE(frame.found[left[0]]);
+  EXPECT_FALSE(frame.found[left[1]]);
+  EXPECT_TRUE(frame.found[right[0]]);
+  EXPECT_TRUE(frame.found[right[1]]);
+  EXPECT_EQ(frame.position[right[0]], 2.);
+  EXPECT_EQ(frame.position[right[1]], 1.);
+
+  ASSERT_TRUE(parse(parser, makeJointState({ "left_1", "left_2" }), frame));
+  EXPECT_FALSE(frame.complete);
+  EXPECT_TRUE(frame.found[left[0]]);
+  EXPECT_TRUE(frame.found[left[1]]);
+  EXPECT_FALSE(frame.found[right[0]]);
+  EXPECT_FALSE(frame.found[right[1]]);
+  EXPECT_EQ(frame.position[left[0]], 1.);
+  EXPECT_EQ(frame.position[left[1]], 2.);
+}
+
+TEST(JointStateParser, JointWithoutPositionIsNotFound)
+{
+  JointStateParser parser;
+  std::vector<std::size_t> indices;
+  ASSERT_TRUE(parser.addJoints({ "a", "b" }, indices));
+
+  sensor_msgs::JointState msg = makeJointState({ "a", "b" });
+  msg.position.resize(1);
+  JointStateFrame frame;
+  ASSERT_TRUE(parse(parser, msg, frame));
+  EXPECT_FALSE(frame.complete);
+  EXPECT_TRUE(frame.found[0]);
+  EXPECT_FALSE(frame.found[1]);
+}
+
+TEST(JointStateParser, MissingVelocities)
+{
+  JointStateParser parser;
+  std::vector<std::size_t> indices;
+  ASSERT_TRUE(parser.addJoints({ "a", "b" }, indices));
+
+  sensor_msgs::JointState msg = makeJointState({ "a", "b" });
+  msg.velocity.clear();
+  JointStateFrame frame;
+  ASSERT_TRUE(parse(parser, msg, frame));
+  EXPECT_TRUE(frame.complete);
+  EXPECT_FALSE(frame.has_velocity);
+  EXPECT_EQ(frame.position[1], 2.);
+}
+
+TEST(JointStateParser, ReorderedNamesAreLookedUpAgain)
+{
+  JointStateParser parser;
+  std::vector<std::size_t> indices;
+  ASSERT_TRUE(parser.addJoints({ "a", "b" }, indices));
+
+  JointStateFrame frame;
+  ASSERT_TRUE(parse(parser, makeJointState({ "a", "b" }), frame));
+  EXPECT_EQ(frame.position[0], 1.);
+  EXPECT_EQ(frame.position[1], 2.);
+
+  // Cached name list
+  sensor_msgs::JointState msg = makeJointState({ "a", "b" });
+  msg.position = { 5., 6. };
+  ASSERT_TRUE(parse(parser, msg, frame));
+  EXPECT_EQ(frame.position[0], 5.);
+  EXPECT_EQ(frame.position[1], 6.);
+
+  ASSERT_TRUE(parse(parser, makeJointState({ "b", "a" }), frame));
+  EXPECT_TRUE(frame.complete);
+  EXPECT_EQ(frame.position[0], 2.);
+  EXPECT_EQ(frame.position[1], 1.);
+
+  // Names of the same length, so only the comparison of the bytes can notice
+  ASSERT_TRUE(parse(parser, makeJointState({ "a", "c" }), frame));
+  EXPECT_FALSE(frame.complete);
+  EXPECT_TRUE(frame.found[0]);
+  EXPECT_FALSE(frame.found[1]);
+}
+
+TEST(JointStateParser, AddingJointsInvalidatesTheCache)
+{
+  JointStateParser parser;
+  std::vector<std::size_t> indices;
+  ASSERT_TRUE(parser.addJoints({ "a" }, indices));
+
+  JointStateFrame frame;
+  ASSERT_TRUE(parse(parser, makeJointState({ "a", "b" }), frame));
+  ASSERT_TRUE(parser.addJoints({ "b" }, indices));
+  ASSERT_TRUE(parse(parser, makeJointState({ "a", "b" }), frame));
+
+  EXPECT_TRUE(frame.complete);
+  EXPECT_EQ(frame.num_joints, 2u);
+  EXPECT_EQ(frame.position[indices[0]], 2.);
+}
+
+TEST(JointStateParser, TruncatedMsgsAreMalformed)
+{
+  JointStateParser parser;
+  std::vector<std::size_t> indices;
+  ASSERT_TRUE(parser.addJoints({ "a", "b" }, indices));
+
+  const std::vector<uint8_t> buffer = serialize(makeJointState({ "a", "b" }));
+  // Efforts are skipped, so only cutting into the velocities or earlier is noticed
+  const uint32_t end_of_velocities = static_cast<uint32_t>(buffer.size()) - 4 - 2 * sizeof(double);
+  JointStateFrame frame;
+  for (uint32_t length = 0; length < end_of_velocities; ++length)
+    EXPECT_FALSE(parser.parse(buffer.data(), length, frame)) << "length " << length;
+  EXPECT_TRUE(parser.parse(buffer.data(), end_of_velocities, frame));
+}
+
+TEST(JointStateParser, HugeLengthsAreMalformed)
+{
+  JointStateParser parser;
+  std::vector<std::size_t> indices;
+  ASSERT_TRUE(parser.addJoints({ "a" }, indices));
+
+  std::vector<uint8_t> buffer = serialize(makeJointState({ "a" }));
+  // The frame_id length, right after seq and stamp
+  buffer[12] = buffer[13] = buffer[14] = buffer[15] = 0xFF;
+  JointStateFrame frame;
+  EXPECT_FALSE(parser.parse(buffer.data(), static_cast<uint32_t>(buffer.size()), frame));
+
+  buffer = serialize(makeJointState({ "a" }));
+  // The number of positions, after the header, the name list and its count
+  const std::size_t positions = 16 + std::string("base_link").size() + 4 + 4 + 1;
+  buffer[positions] = buffer[positions + 1] = buffer[positions + 2] = buffer[positions + 3] = 0xFF;
+  EXPECT_FALSE(parser.parse(buffer.data(), static_cast<uint32_t>(buffer.size()), frame));
+}
+
+struct ParseThreadArgs
+{
+  JointStateParser* parser;
+  std::vector<uint8_t> buffer;
+  double expected_position;
+  bool ok = true;
+};
+
+void* parseRepeatedly(void* args)
+{
+  ParseThreadArgs& thread_args = *static_cast<ParseThreadArgs*>(args);
+  for (int i = 0; i < 2000; ++i)
+  {
+    const std::vector<uint8_t>& buffer = thread_args.buffer;
+    JointStateFrame frame;
+    const bool valid = thread_args.parser->parse(buffer.data(), static_cast<uint32_t>(buffer.size()), frame);
+    if (!valid || !frame.complete || frame.position[0] != thread_args.expected_position)
+      thread_args.ok = false;
+  }
+  return nullptr;
+}
+
+TEST(JointStateParser, ConcurrentMsgsWithDifferentNameOrders)
+{
+  JointStateParser parser;
+  std::vector<std::size_t> indices;
+  ASSERT_TRUE(parser.addJoints({ "a", "b" }, indices));
+
+  // Each thread's msgs make the parser look the names up again
+  ParseThreadArgs forward, reversed;
+  forward.parser = reversed.parser = &parser;
+  forward.buffer = serialize(makeJointState({ "a", "b" }));
+  forward.expected_position = 1.;
+  reversed.buffer = serialize(makeJointState({ "b", "a" }));
+  reversed.expected_position = 2.;
+
+  pthread_t forward_thread, reversed_thread;
+  ASSERT_EQ(pthread_create(&forward_thread, nullptr, &parseRepeatedly, &forward), 0);
+  ASSERT_EQ(pthread_create(&reversed_thread, nullptr, &parseRepeatedly, &reversed), 0);
+  pthread_join(forward_thread, nullptr);
+  pthread_join(reversed_thread, nullptr);
+
+  EXPECT_TRUE(forward.ok);
+  EXPECT_TRUE(reversed.ok);
+}
+}  // namespace
+}  // namespace jog_arm
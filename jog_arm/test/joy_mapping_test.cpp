@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : joy_mapping_test.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Unit tests for the joystick mapping.
+
+#include <gtest/gtest.h>
+#include <jog_arm/joy_mapping.h>
+
+namespace jog_arm
+{
+namespace
+{
+const double EPSILON = 1e-9;
+
+JoyInputMapping axisMapping(int axis)
+{
+  JoyInputMapping mapping;
+  mapping.axis = axis;
+  return mapping;
+}
+
+TEST(JoyMapping, AxisPassesThrough)
+{
+  const JoyInputMapping mapping = axisMapping(1);
+  EXPECT_NEAR(mapping.apply({ 0.f, -0.25f }, {}), -0.25, EPSILON);
+  EXPECT_NEAR(mapping.apply({ 0.f, 1.f }, {}), 1., EPSILON);
+}
+
+// The output starts from zero at the edge of the deadzone and still reaches full scale
+TEST(JoyMapping, DeadzoneIsStretched)
+{
+  JoyInputMapping mapping = axisMapping(0);
+  mapping.deadzone = 0.2;
+  EXPECT_EQ(mapping.apply({ 0.15f }, {}), 0.);
+  EXPECT_EQ(mapping.apply({ -0.19f }, {}), 0.);
+  EXPECT_NEAR(mapping.apply({ 0.6f }, {}), 0.5, 1e-6);
+  EXPECT_NEAR(mapping.apply({ -1.f }, {}), -1., EPSILON);
+}
+
+TEST(JoyMapping, ExponentAndScale)
+{
+  JoyInputMapping mapping = axisMapping(0);
+  mapping.exponent = 2.;
+  mapping.scale = -3.;
+  EXPECT_NEAR(mapping.apply({ 0.5f }, {}), -0.75, EPSILON);
+  EXPECT_NEAR(mapping.apply({ -0.5f }, {}), 0.75, EPSILON);
+}
+
+TEST(JoyMapping, ButtonPair)
+{
+  JoyInputMapping mapping;
+  mapping.positive_button = 2;
+  mapping.negative_button = 0;
+  EXPECT_EQ(mapping.apply({}, { 0, 0, 1 }), 1.);
+  EXPECT_EQ(mapping.apply({}, { 1, 0, 0 }), -1.);
+  EXPECT_EQ(mapping.apply({}, { 1, 0, 1 }), 0.);
+  EXPECT_EQ(mapping.apply({}, { 0, 0, 0 }), 0.);
+}
+
+// Inputs the device does not have read as zero, instead of reading past the end
+TEST(JoyMapping, MissingInputsReadAsZero)
+{
+  EXPECT_EQ(axisMapping(4).apply({ 1.f, 1.f }, {}), 0.);
+
+  JoyInputMapping mapping;
+  mapping.positive_button = 7;
+  EXPECT_EQ(mapping.apply({}, { 1, 1 }), 0.);
+}
+
+TEST(JoyMapping, ApplyWholeDevice)
+{
+  JoyMapping mapping;
+  mapping.twist[0] = axisMapping(0);
+  mapping.twist[5].positive_button = 1;
+  mapping.joint_names = { "elbow" };
+  mapping.joints.push_back(axisMapping(1));
+
+  std::array<double, 6> twist;
+  std::vector<double> joint_deltas;
+  applyJoyMapping(mapping, { 0.5f, -1.f }, { 0, 1 }, twist, joint_deltas);
+
+  EXPECT_NEAR(twist[0], 0.5, EPSILON);
+  for (std::size_t i = 1; i < 5; ++i)
+    EXPECT_EQ(twist[i], 0.) << TWIST_COMPONENT_NAMES[i];
+  EXPECT_EQ(twist[5], 1.);
+  ASSERT_EQ(joint_deltas.size(), 1u);
+  EXPECT_NEAR(joint_deltas[0], -1., EPSILON);
+}
+
+TEST(JoyMapping, Validate)
+{
+  EXPECT_TRUE(validateJoyInputMapping(axisMapping(0)).empty());
+
+  JoyInputMapping both = axisMapping(0);
+  both.positive_button = 1;
+  EXPECT_FALSE(validateJoyInputMapping(both).empty());
+
+  JoyInputMapping bad_deadzone = axisMapping(0);
+  bad_deadzone.deadzone = 1.;
+  EXPECT_FALSE(validateJoyInputMapping(bad_deadzone).empty());
+
+  JoyInputMapping bad_exponent = axisMapping(0);
+  bad_exponent.exponent = 0.;
+  EXPECT_FALSE(validateJoyInputMapping(bad_exponent).empty());
+}
+}  // namespace
+}  // namespace jog_arm
@@ -0,0 +1,297 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : low_pass_filter_bank_test.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Unit tests for LowPassFilterBank.
+
+#include <gtest/gtest.h>
+#include <jog_arm/low_pass_filter_bank.h>
+#include <cmath>
+
+namespace jog_arm
+{
+namespace
+{
+const double EPSILON = 1e-12;
+
+// Steady-state gain at a frequency [Hz]. A cosine and a sine are filtered side by side,
+// so the magnitude of the output pair is exactly the gain, with no need to catch a peak.
+double gainAt(const FilterSpec& spec, const double frequency)
+{
+  LowPassFilterBank bank(2, spec);
+  double data[2] = { 0., 0. };
+  double phase = 0.;
+  for (int i = 0; i < 5000; ++i)
+  {
+    phase = 2. * M_PI * frequency * spec.sample_period * i;
+    data[0] = std::cos(phase);
+    data[1] = std::sin(phase);
+    bank.filter(data);
+  }
+  return std::hypot(data[0], data[1]);
+}
+
+// Every channel must be filtered exactly as if it had a bank of its own
+TEST(LowPassFilterBank, ChannelsAreIndependent)
+{
+  FilterSpec spec;
+  LowPassFilterBank bank(3, spec);
+  LowPassFilterBank channel_0(1, spec), channel_1(1, spec), channel_2(1, spec);
+
+  for (int i = 0; i < 50; ++i)
+  {
+    Eigen::ArrayXd input(3);
+    input << i % 7, -0.5 * i, (i % 2) ? 1. : -1.;
+
+    Eigen::ArrayXd output(3);
+    bank.filter(input, output);
+
+    EXPECT_NEAR(output[0], channel_0.filter(input[0]), EPSILON);
+    EXPECT_NEAR(output[1], channel_1.filter(input[1]), EPSILON);
+    EXPECT_NEAR(output[2], channel_2.filter(input[2]), EPSILON);
+  }
+}
+
+TEST(LowPassFilterBank, InPlaceMatchesSeparateOutput)
+{
+  FilterSpec spec;
+  LowPassFilterBank in_place(2, spec), separate(2, spec);
+
+  for (int i = 0; i < 20; ++i)
+  {
+    double data[2] = { 1. * i, 2. - i };
+    Eigen::ArrayXd input(2), output(2);
+    input << data[0], data[1];
+
+    in_place.filter(data);
+    separate.filter(input, output);
+
+    EXPECT_NEAR(data[0], output[0], EPSILON);
+    EXPECT_NEAR(data[1], output[1], EPSILON);
+  }
+}
+
+// After a reset the filter must sit still at the given values
+TEST(LowPassFilterBank, ResetIsSteadyState)
+{
+  FilterSpec spec;
+  LowPassFilterBank bank(2, spec);
+  const double steady_state[2] = { 0.3, -1.2 };
+  bank.reset(steady_state);
+
+  for (int i = 0; i < 10; ++i)
+  {
+    double data[2] = { steady_state[0], steady_state[1] };
+    bank.filter(data);
+    EXPECT_NEAR(data[0], steady_state[0], EPSILON);
+    EXPECT_NEAR(data[1], steady_state[1], EPSILON);
+  }
+}
+
+TEST(LowPassFilterBank, ConvergesToConstantInput)
+{
+  FilterSpec spec;
+  LowPassFilterBank bank(1, spec);
+
+  double output = 0.;
+  for (int i = 0; i < 500; ++i)
+    output = bank.filter(2.5);
+  EXPECT_NEAR(output, 2.5, 1e-9);
+}
+
+// The bilinear transform is pre-warped, so the cutoff is exactly -3dB even close to Nyquist
+TEST(LowPassFilterBank, ButterworthIsHalfPowerAtCutoff)
+{
+  FilterSpec spec;
+  spec.sample_period = 0.01;
+  for (int order = 1; order <= 4; ++order)
+  {
+    spec.order = order;
+    for (double cutoff : { 1., 10., 40. })
+    {
+      spec.cutoff_frequency = cutoff;
+      EXPECT_NEAR(gainAt(spec, cutoff), M_SQRT1_2, 1e-6) << "order " << order << ", cutoff " << cutoff;
+    }
+  }
+}
+
+// Every Butterworth section has a zero at z = -1
+TEST(LowPassFilterBank, ButterworthRejectsNyquist)
+{
+  FilterSpec spec;
+  spec.order = 3;
+  LowPassFilterBank bank(1, spec);
+
+  double output = 0.;
+  for (int i = 0; i < 2000; ++i)
+    output = bank.filter((i % 2) ? 1. : -1.);
+  EXPECT_NEAR(output, 0., 1e-9);
+}
+
+TEST(LowPassFilterBank, CriticallyDampedIsHalfPowerAtCutoff)
+{
+  FilterSpec spec;
+  spec.type = FilterType::CRITICALLY_DAMPED;
+  for (int order = 1; order <= 4; ++order)
+  {
+    spec.order = order;
+    for (double cutoff : { 5., 30. })
+    {
+      spec.cutoff_frequency = cutoff;
+      EXPECT_NEAR(gainAt(spec, cutoff), M_SQRT1_2, 1e-6) << "order " << order << ", cutoff " << cutoff;
+    }
+  }
+}
+
+// The step response of a critically damped filter never overshoots
+TEST(LowPassFilterBank, CriticallyDampedDoesNotOvershoot)
+{
+  FilterSpec spec;
+  spec.type = FilterType::CRITICALLY_DAMPED;
+  spec.order = 4;
+  LowPassFilterBank bank(1, spec);
+
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_LE(bank.filter(1.), 1. + EPSILON);
+}
+
+TEST(LowPassFilterBank, OneEuroTracksConstantInput)
+{
+  FilterSpec spec;
+  spec.type = FilterType::ONE_EURO;
+  spec.cutoff_frequency = 1.;
+  spec.one_euro_beta = 0.5;
+  LowPassFilterBank bank(1, spec);
+  bank.reset(0.);
+
+  double output = 0.;
+  for (int i = 0; i < 2000; ++i)
+    output = bank.filter(1.);
+  EXPECT_NEAR(output, 1., 1e-6);
+}
+
+// A larger beta raises the cutoff on fast motion, so the filter lags less
+TEST(LowPassFilterBank, OneEuroBetaReducesLag)
+{
+  FilterSpec spec;
+  spec.type = FilterType::ONE_EURO;
+  spec.cutoff_frequency = 1.;
+  LowPassFilterBank slow(1, spec);
+  spec.one_euro_beta = 1.;
+  LowPassFilterBank fast(1, spec);
+
+  double slow_output = 0., fast_output = 0.;
+  for (int i = 0; i < 20; ++i)
+  {
+    slow_output = slow.filter(0.1 * i);
+    fast_output = fast.filter(0.1 * i);
+  }
+  EXPECT_GT(fast_output, slow_output);
+}
+
+// The old coefficient was 1/tan(pi*fc*T)
+TEST(LowPassFilterBank, CutoffFromCoefficient)
+{
+  const double sample_period = 0.01;
+  for (double coeff : { 1.5, 2., 10., 100. })
+  {
+    const double cutoff = LowPassFilterBank::cutoffFromCoefficient(coeff, sample_period);
+    EXPECT_NEAR(1. / std::tan(M_PI * cutoff * sample_period), coeff, 1e-9);
+    EXPECT_LT(cutoff, 0.5 / sample_period);
+  }
+}
+
+TEST(LowPassFilterBank, Validate)
+{
+  FilterSpec spec;
+  EXPECT_TRUE(LowPassFilterBank::validate(spec).empty());
+
+  FilterSpec bad = spec;
+  bad.cutoff_frequency = 0.5 / bad.sample_period;
+  EXPECT_FALSE(LowPassFilterBank::validate(bad).empty());
+
+  bad = spec;
+  bad.order = 5;
+  EXPECT_FALSE(LowPassFilterBank::validate(bad).empty());
+
+  bad = spec;
+  bad.sample_period = 0.;
+  EXPECT_FALSE(LowPassFilterBank::validate(bad).empty());
+
+  // one_euro has no Nyquist limit or order
+  bad.sample_period = spec.sample_period;
+  bad.type = FilterType::ONE_EURO;
+  bad.order = 5;
+  bad.cutoff_frequency = 100.;
+  EXPECT_TRUE(LowPassFilterBank::validate(bad).empty());
+  bad.one_euro_beta = -1.;
+  EXPECT_FALSE(LowPassFilterBank::validate(bad).empty());
+}
+
+TEST(LowPassFilterBank, ParseFilterType)
+{
+  FilterType type;
+  ASSERT_TRUE(parseFilterType("critically_damped", type));
+  EXPECT_EQ(type, FilterType::CRITICALLY_DAMPED);
+  ASSERT_TRUE(parseFilterType("one_euro", type));
+  EXPECT_EQ(type, FilterType::ONE_EURO);
+  ASSERT_TRUE(parseFilterType("butterworth", type));
+  EXPECT_EQ(type, FilterType::BUTTERWORTH);
+  EXPECT_FALSE(parseFilterType("chebyshev", type));
+}
+
+// Changing the response while running must not make the output jump
+TEST(LowPassFilterBank, SetSpecIsContinuous)
+{
+  FilterSpec spec;
+  for (FilterType new_type : { FilterType::BUTTERWORTH, FilterType::CRITICALLY_DAMPED, FilterType::ONE_EURO })
+  {
+    LowPassFilterBank bank(1, spec);
+    double output = 0.;
+    for (int i = 0; i < 300; ++i)
+      output = bank.filter(1.);
+
+    FilterSpec new_spec = spec;
+    new_spec.type = new_type;
+    new_spec.cutoff_frequency = 3.;
+    new_spec.order = 3;
+    bank.setSpec(new_spec);
+    EXPECT_NEAR(bank.filter(1.), output, 1e-6);
+  }
+}
+}  // namespace
+}  // namespace jog_arm
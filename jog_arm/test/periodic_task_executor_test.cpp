@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : periodic_task_executor_test.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Unit tests for PeriodicTaskExecutor.
+
+#include <gtest/gtest.h>
+#include <jog_arm/periodic_task_executor.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace jog_arm
+{
+namespace
+{
+// Poll until condition is true or about a second has passed
+template <typename Condition>
+bool waitFor(Condition condition)
+{
+  for (int i = 0; i < 1000 && !condition(); ++i)
+    usleep(1000);
+  return condition();
+}
+
+TEST(PeriodicTaskExecutor, RunsPeriodically)
+{
+  PeriodicTaskExecutor executor(2);
+  std::atomic<int> runs{ 0 };
+  const std::size_t task = executor.addTask("count", 0.01, 0., 0, [&runs]() { ++runs; });
+  ASSERT_TRUE(executor.start());
+
+  usleep(200000);
+  executor.stop();
+
+  // About 20 runs. Leave room for a loaded machine.
+  EXPECT_GE(runs, 10);
+  EXPECT_LE(runs, 22);
+  EXPECT_EQ(executor.getStatistics(task).runs, static_cast<uint64_t>(runs));
+  EXPECT_EQ(executor.getStatistics(task).name, "count");
+}
+
+// The most urgent ready job runs first, whichever worker ran its task before
+TEST(PeriodicTaskExecutor, PriorityHoldsAcrossWorkers)
+{
+  PeriodicTaskExecutor executor(2);
+  ASSERT_TRUE(executor.start());
+
+  // Keep both workers busy
+  std::atomic<int> blocked{ 0 };
+  std::atomic<bool> release[2] = { { false }, { false } };
+  for (int i = 0; i < 2; ++i)
+  {
+    std::atomic<bool>& my_release = release[i];
+    executor.addTask("blocker", 10., 0., 10, [&blocked, &my_release]() {
+      ++blocked;
+      while (!my_release)
+        usleep(100);
+    });
+  }
+  ASSERT_TRUE(waitFor([&blocked]() { return blocked == 2; }));
+
+  std::mutex order_mutex;
+  std::vector<std::string> order;
+  auto record = [&order_mutex, &order](const std::string& name) {
+    std::lock_guard<std::mutex> lock(order_mutex);
+    order.push_back(name);
+  };
+  executor.addTask("low", 10., 0., 0, [&record]() { record("low"); });
+  executor.addTask("high", 10., 0., 5, [&record]() { record("high"); });
+  // Let the dispatcher release both while the workers are busy
+  usleep(20000);
+
+  release[0] = true;
+  ASSERT_TRUE(waitFor([&order_mutex, &order]() {
+    std::lock_guard<std::mutex> lock(order_mutex);
+    return order.size() == 2;
+  }));
+  release[1] = true;
+  executor.stop();
+
+  EXPECT_EQ(order[0], "high");
+  EXPECT_EQ(order[1], "low");
+}
+
+// A task that is still running when its next release is due skips that release
+TEST(PeriodicTaskExecutor, CountsOverruns)
+{
+  PeriodicTaskExecutor executor(2);
+  const std::size_t task = executor.addTask("slow", 0.01, 0., 0, []() { usleep(35000); });
+  ASSERT_TRUE(executor.start());
+  usleep(200000);
+  executor.stop();
+
+  const PeriodicTaskExecutor::TaskStatistics statistics = executor.getStatistics(task);
+  EXPECT_GT(statistics.runs, 0u);
+  EXPECT_GT(statistics.overruns, statistics.runs);
+  EXPECT_GE(statistics.max_duration, 0.035);
+}
+
+TEST(PeriodicTaskExecutor, PauseAndResume)
+{
+  PeriodicTaskExecutor executor(1);
+  std::atomic<int> runs{ 0 };
+  const std::size_t task = executor.addTask("count", 0.005, 0., 0, [&runs]() { ++runs; });
+  ASSERT_TRUE(executor.start());
+  ASSERT_TRUE(waitFor([&runs]() { return runs > 0; }));
+
+  executor.pauseTask(task);
+  usleep(20000);
+  const int paused_runs = runs;
+  usleep(50000);
+  EXPECT_EQ(runs, paused_runs);
+
+  executor.resumeTask(task);
+  EXPECT_TRUE(waitFor([&runs, paused_runs]() { return runs > paused_runs; }));
+  executor.stop();
+}
+
+// removeTask() returns only once the task is not running, and it never runs again
+TEST(PeriodicTaskExecutor, RemoveWaitsForRunningTask)
+{
+  PeriodicTaskExecutor executor(2);
+  std::atomic<bool> running{ false };
+  std::atomic<int> runs{ 0 };
+  const std::size_t task = executor.addTask("slow", 0.001, 0., 0, [&running, &runs]() {
+    running = true;
+    usleep(20000);
+    ++runs;
+    running = false;
+  });
+  ASSERT_TRUE(executor.start());
+  ASSERT_TRUE(waitFor([&running]() { return running.load(); }));
+
+  executor.removeTask(task);
+  EXPECT_FALSE(running);
+  const int removed_runs = runs;
+  usleep(50000);
+  EXPECT_EQ(runs, removed_runs);
+  executor.stop();
+}
+
+TEST(PeriodicTaskExecutor, Restarts)
+{
+  PeriodicTaskExecutor executor(1);
+  std::atomic<int> runs{ 0 };
+  executor.addTask("count", 0.005, 0., 0, [&runs]() { ++runs; });
+
+  ASSERT_TRUE(executor.start());
+  ASSERT_TRUE(waitFor([&runs]() { return runs > 0; }));
+  executor.stop();
+
+  const int stopped_runs = runs;
+  usleep(20000);
+  EXPECT_EQ(runs, stopped_runs);
+
+  ASSERT_TRUE(executor.start());
+  EXPECT_TRUE(waitFor([&runs, stopped_runs]() { return runs > stopped_runs; }));
+  executor.stop();
+}
+}  // namespace
+}  // namespace jog_arm
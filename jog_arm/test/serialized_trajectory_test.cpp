@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////////////
+//      Title     : serialized_trajectory_test.cpp
+//      Project   : jog_arm
+//      Created   : 10/17/2026
+//
+// BSD 3-Clause License
+//
+// Copyright (c) 2018, Los Alamos National Security, LLC
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+//
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+//
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Unit tests for the serialized outgoing trajectories.
+
+#include <gtest/gtest.h>
+#include <jog_arm/serialized_trajectory.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace jog_arm
+{
+namespace
+{
+JogTrajectory makeTrajectory(CycleArena* arena, std::size_t num_joints)
+{
+  const ArenaAllocator<void> allocator(arena);
+  JogTrajectory trajectory(allocator);
+  trajectory.header.seq = 7;
+  trajectory.header.stamp.sec = 100;
+  trajectory.header.stamp.nsec = 250;
+  trajectory.header.frame_id = "base_link";
+  for (std::size_t i = 0; i < num_joints; ++i)
+  {
+    const std::string name = "joint_" + std::to_string(i);
+    trajectory.joint_names.push_back(JogTrajectory::_joint_names_type::value_type(name.c_str(), allocator));
+  }
+
+  JogTrajectoryPoint point(allocator);
+  for (std::size_t i = 0; i < num_joints; ++i)
+  {
+    point.positions.push_back(0.1 * i);
+    point.velocities.push_back(-0.2 * i);
+  }
+  point.time_from_start.sec = 0;
+  point.time_from_start.nsec = 8000000;
+  trajectory.points.push_back(point);
+  return trajectory;
+}
+
+// The bytes of the same message, as a plain trajectory_msgs/JointTrajectory
+std::vector<uint8_t> serializeReference(const JogTrajectory& trajectory)
+{
+  trajectory_msgs::JointTrajectory reference;
+  reference.header.seq = trajectory.header.seq;
+  reference.header.stamp = trajectory.header.stamp;
+  reference.header.frame_id.assign(trajectory.header.frame_id.begin(), trajectory.header.frame_id.end());
+  for (const auto& name : trajectory.joint_names)
+    reference.joint_names.emplace_back(name.begin(), name.end());
+  for (const JogTrajectoryPoint& point : trajectory.points)
+  {
+    trajectory_msgs::JointTrajectoryPoint reference_point;
+    reference_point.positions.assign(point.positions.begin(), point.positions.end());
+    reference_point.velocities.assign(point.velocities.begin(), point.velocities.end());
+    reference_point.accelerations.assign(point.accelerations.begin(), point.accelerations.end());
+    reference_point.effort.assign(point.effort.begin(), point.effort.end());
+    reference_point.time_from_start = point.time_from_start;
+    reference.points.push_back(reference_point);
+  }
+
+  std::vector<uint8_t> buffer(ros::serialization::serializationLength(reference));
+  ros::serialization::OStream stream(buffer.data(), static_cast<uint32_t>(buffer.size()));
+  ros::serialization::serialize(stream, reference);
+  return buffer;
+}
+
+std::vector<uint8_t> bytes(const SerializedTrajectory& serialized)
+{
+  return std::vector<uint8_t>(serialized.data(), serialized.data() + serialized.size());
+}
+
+TEST(SerializedTrajectory, FirstUpdateMatchesRosSerialization)
+{
+  const JogTrajectory trajectory = makeTrajectory(nullptr, 6);
+  SerializedTrajectory serialized;
+  serialized.update(trajectory);
+
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+  EXPECT_EQ(ros::serialization::serializationLength(serialized), serialized.size());
+}
+
+TEST(SerializedTrajectory, InPlaceUpdateWritesTheHeaderAndNumbers)
+{
+  JogTrajectory trajectory = makeTrajectory(nullptr, 6);
+  SerializedTrajectory serialized;
+  serialized.update(trajectory);
+  const uint8_t* data = serialized.data();
+
+  // Same layout: only seq, stamp, the arrays and time_from_start change
+  trajectory.header.seq = 0x01020304;
+  trajectory.header.stamp.sec = 0xA0B0C0D0;
+  trajectory.header.stamp.nsec = 999999999;
+  for (std::size_t i = 0; i < 6; ++i)
+  {
+    trajectory.points[0].positions[i] = 1.5 + i;
+    trajectory.points[0].velocities[i] = -3.25 * i;
+  }
+  trajectory.points[0].time_from_start.sec = 2;
+  trajectory.points[0].time_from_start.nsec = 5;
+  serialized.update(trajectory);
+
+  EXPECT_EQ(serialized.data(), data);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+}
+
+TEST(SerializedTrajectory, ArenaAndHeapTrajectoriesGiveTheSameBytes)
+{
+  CycleArena arena;
+  const JogTrajectory in_arena = makeTrajectory(&arena, 7);
+  const JogTrajectory on_heap = makeTrajectory(nullptr, 7);
+  SerializedTrajectory from_arena, from_heap;
+  from_arena.update(in_arena);
+  from_heap.update(on_heap);
+
+  EXPECT_EQ(bytes(from_arena), bytes(from_heap));
+}
+
+TEST(SerializedTrajectory, FrameChangeOfTheSameLengthReserializes)
+{
+  JogTrajectory trajectory = makeTrajectory(nullptr, 6);
+  SerializedTrajectory serialized;
+  serialized.update(trajectory);
+
+  // Same length as "base_link", so only the comparison of the bytes can notice
+  trajectory.header.frame_id = "tool_link";
+  serialized.update(trajectory);
+
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+}
+
+TEST(SerializedTrajectory, JointNameChangeReserializes)
+{
+  JogTrajectory trajectory = makeTrajectory(nullptr, 6);
+  SerializedTrajectory serialized;
+  serialized.update(trajectory);
+
+  trajectory.joint_names[3] = "joint_x";
+  serialized.update(trajectory);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+
+  trajectory.joint_names[3] = "a_longer_joint_name";
+  serialized.update(trajectory);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+}
+
+TEST(SerializedTrajectory, ArraySizeChangeReserializes)
+{
+  JogTrajectory trajectory = makeTrajectory(nullptr, 6);
+  SerializedTrajectory serialized;
+  serialized.update(trajectory);
+
+  // E.g. publish_joint_accelerations switched on by a reload
+  trajectory.points[0].accelerations.assign(6, 0.75);
+  serialized.update(trajectory);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+
+  // And the velocities switched off, which keeps the total size
+  trajectory.points[0].velocities.clear();
+  trajectory.points[0].effort.assign(6, 0.5);
+  serialized.update(trajectory);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+
+  // Back to the same layout, then numbers change in place
+  trajectory.points[0].effort[2] = -1.;
+  serialized.update(trajectory);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+}
+
+TEST(SerializedTrajectory, PointCountChangeReserializes)
+{
+  JogTrajectory trajectory = makeTrajectory(nullptr, 3);
+  SerializedTrajectory serialized;
+  serialized.update(trajectory);
+
+  // Gazebo gets a second point
+  trajectory.points.push_back(trajectory.points[0]);
+  trajectory.points[1].time_from_start.nsec = 16000000;
+  trajectory.points[1].positions[0] = 4.;
+  serialized.update(trajectory);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+
+  trajectory.points[1].positions[2] = -4.;
+  trajectory.points[1].time_from_start.nsec = 24000000;
+  serialized.update(trajectory);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+
+  trajectory.points.pop_back();
+  serialized.update(trajectory);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+}
+
+TEST(SerializedTrajectory, EmptyTrajectory)
+{
+  JogTrajectory trajectory;
+  SerializedTrajectory serialized;
+  serialized.update(trajectory);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+
+  trajectory.header.seq = 3;
+  serialized.update(trajectory);
+  EXPECT_EQ(bytes(serialized), serializeReference(trajectory));
+}
+}  // namespace
+}  // namespace jog_arm